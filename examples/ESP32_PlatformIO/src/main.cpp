@@ -82,7 +82,8 @@ void setup() {
   // Start with PEC disabled for initial communication
   bq4050.setPECEnabled(false);
   
-  // Initialize BQ4050
+  // Initialize BQ4050 and measure the response/MAC settle times of this board
+  bq4050.setCalibrateOnBegin(true);
   if (!bq4050.begin()) {
     Serial.println("ERROR: Failed to initialize BQ4050!");
     Serial.print("Last error: ");
@@ -92,37 +93,21 @@ void setup() {
   }
   
   Serial.println("BQ4050 initialized successfully!");
+  TimingProfile timing = bq4050.getTimingProfile();
+  Serial.printf("Calibrated timing: response %u us, MAC %u us\n", timing.responseDelayUs, timing.macDelayUs);
+
+  // Start at 50 kHz above, then climb to the fastest rate this wiring carries cleanly
+  uint32_t busSpeed = bq4050.autotuneBusSpeed();
+  bq4050.setBusSpeedFallback(true);
+  Serial.printf("Bus speed: %lu Hz\n", (unsigned long)busSpeed);
   Serial.println();
   
-  // Test device identification with retries
+  // Test device identification (the driver retries 0xFFA5/0xFFFF/0x0000 itself)
   Serial.println("=== Device Information ===");
   
-  // Add extra delays for manufacturer access commands
-  delay(100);
   uint16_t deviceType = bq4050.getDeviceType();
-  delay(50);
-  
-  // Check if we got a valid device type, retry if not
-  if (deviceType == 0xFFA5 || deviceType == 0xFFFF || deviceType == 0x0000) {
-    Serial.println("Retrying device type read...");
-    delay(100);
-    deviceType = bq4050.getDeviceType();
-    delay(50);
-  }
-  
   uint16_t fwVersion = bq4050.getFirmwareVersion();
-  delay(50);
-  
-  // Check if we got a valid firmware version, retry if not
-  if (fwVersion == 0xFFA5 || fwVersion == 0xFFFF || fwVersion == 0x0000) {
-    Serial.println("Retrying firmware version read...");
-    delay(100);
-    fwVersion = bq4050.getFirmwareVersion();
-    delay(50);
-  }
-  
   uint16_t hwVersion = bq4050.getHardwareVersion();
-  delay(50);
   
   Serial.print("Device Type: 0x");
   Serial.println(deviceType, HEX);
@@ -142,11 +127,8 @@ void setup() {
   // Test enhanced manufacturer access functions
   Serial.println();
   Serial.println("=== Enhanced Manufacturer Access Data ===");
-  delay(50);
   String deviceTypeBlock = bq4050.getDeviceTypeBlock();
-  delay(50);
   String firmwareBlock = bq4050.getFirmwareVersionBlock();  
-  delay(50);
   String hardwareBlock = bq4050.getHardwareVersionBlock();
   
   Serial.print("Device Type Block: ");
@@ -159,11 +141,8 @@ void setup() {
   // Test additional sealed-mode commands
   Serial.println();
   Serial.println("=== Additional Sealed-Mode Commands ===");
-  delay(50);
   uint16_t ifChecksum = bq4050.getIFChecksum();
-  delay(50);
   uint16_t staticDFSig = bq4050.getStaticDFSignature();
-  delay(50);
   uint16_t allDFSig = bq4050.getAllDFSignature();
   
   Serial.print("IF Checksum: 0x");
@@ -183,18 +162,14 @@ void setup() {
   Serial.println(GET_SECURITY_DESC(securityMode));
   
   // Test cycle count reading
-  delay(50);
   uint16_t cycleCount = bq4050.getCycleCount();
-  delay(10);
   
   Serial.print("Cycle Count: ");
   Serial.println(FORMAT_CYCLE_COUNT(cycleCount));
   
   // Get manufacturer date and serial number
   uint16_t mfgDate = bq4050.getManufacturerDate();
-  delay(10);
   uint16_t serialNumber = bq4050.getSerialNumber();
-  delay(10);
   
   Serial.print("Manufacturer Date: ");
   Serial.println(FORMAT_MFG_DATE(mfgDate));
@@ -203,32 +178,26 @@ void setup() {
   
   // Get manufacturer name with retry
   Serial.print("Manufacturer: ");
-  delay(50);
   String manufacturer = bq4050.getManufacturerName();
   if (manufacturer.length() == 0) {
     Serial.print("(retrying...) ");
-    delay(100);
     manufacturer = bq4050.getManufacturerName();
   }
   Serial.println(manufacturer);
   
   // Get device name with retry
   Serial.print("Device Name: ");
-  delay(50);
   String deviceName = bq4050.getDeviceName();
   if (deviceName.length() == 0) {
     Serial.print("(retrying...) ");
-    delay(100);
     deviceName = bq4050.getDeviceName();
   }
   Serial.println(deviceName);
   
   // Get chemistry with retry
-  delay(50);
   String chemistry = bq4050.getDeviceChemistry();
   if (chemistry.length() == 0) {
     Serial.print("Chemistry: (retrying...) ");
-    delay(100);
     chemistry = bq4050.getDeviceChemistry();
   }
   Serial.print("Chemistry: ");
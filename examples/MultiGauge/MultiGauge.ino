@@ -0,0 +1,77 @@
+/*
+  BQ4050 Multi-Gauge Example
+  
+  This example polls four packs that share one I2C bus through a TCA9548A
+  multiplexer (all BQ4050s answer at 0x0B, so each sits on its own channel).
+  BQ4050Manager orders every sweep so each occupied channel is selected at
+  most once, and reports how many mux switches the sweep needed.
+  
+  Hardware Requirements:
+  - Arduino-compatible board
+  - TCA9548A I2C multiplexer at 0x70
+  - BQ4050 packs on mux channels 0-3
+  
+  Author: Andy Shinn
+  Date: 2024
+*/
+
+#include <Wire.h>
+#include <BQ4050.h>
+#include <BQ4050Manager.h>
+
+const uint8_t PACK_COUNT = 4;
+
+BQ4050WireTransport bus(Wire);
+BQ4050Mux mux(bus, 0x70);
+BQ4050MuxChannel channels[PACK_COUNT] = {
+  BQ4050MuxChannel(mux, 0), BQ4050MuxChannel(mux, 1),
+  BQ4050MuxChannel(mux, 2), BQ4050MuxChannel(mux, 3)
+};
+BQ4050 packs[PACK_COUNT] = {
+  BQ4050(channels[0]), BQ4050(channels[1]), BQ4050(channels[2]), BQ4050(channels[3])
+};
+
+BQ4050Manager manager;
+BatterySnapshot snapshots[PACK_COUNT];
+
+void setup() {
+  Serial.begin(115200);
+  Serial.println("BQ4050 Multi-Gauge Example");
+  Serial.println("==========================");
+
+  for (uint8_t i = 0; i < PACK_COUNT; i++) {
+    manager.addGauge(packs[i], &mux, i);
+  }
+
+  if (!manager.beginAll()) {
+    Serial.println("Warning: not every pack responded");
+  }
+}
+
+void loop() {
+  uint8_t ok = manager.sweep(SNAPSHOT_BASIC | SNAPSHOT_CELL_VOLTAGES, snapshots);
+
+  for (uint8_t i = 0; i < PACK_COUNT; i++) {
+    Serial.print("Pack ");
+    Serial.print(i);
+    Serial.print(": ");
+    Serial.print(snapshots[i].voltage, 3);
+    Serial.print("V ");
+    Serial.print(snapshots[i].current, 3);
+    Serial.print("A ");
+    Serial.print(snapshots[i].relativeSOC);
+    Serial.println("%");
+  }
+
+  Serial.print(ok);
+  Serial.print("/");
+  Serial.print(PACK_COUNT);
+  Serial.print(" packs read in ");
+  Serial.print(manager.getLastSweepUs());
+  Serial.print("us with ");
+  Serial.print(manager.getLastSweepSwitches());
+  Serial.println(" mux switches");
+  Serial.println();
+
+  delay(2000);
+}
@@ -0,0 +1,81 @@
+/*
+  BQ4050 Simulator Benchmark Example
+  
+  This example runs the library against BQ4050Simulator instead of a real
+  pack, so driver changes can be exercised and timed without hardware.
+  Each operation is timed and reported together with the number of bus
+  transactions it cost.
+  
+  Hardware Requirements:
+  - Any board with ~16KB of free RAM (the simulator shadows 8KB of data flash),
+    or a Linux host with an Arduino-compatible core
+  - No BQ4050 required
+  
+  Author: Andy Shinn
+  Date: 2024
+*/
+
+#include <BQ4050.h>
+#include <BQ4050Simulator.h>
+
+BQ4050Simulator simulator;
+BQ4050 battery(simulator);
+
+void report(const char* name, uint32_t startUs, uint32_t startTransactions) {
+  uint32_t elapsed = micros() - startUs;
+  Serial.print(name);
+  Serial.print(": ");
+  Serial.print(elapsed);
+  Serial.print("us, ");
+  Serial.print(simulator.getTransactionCount() - startTransactions);
+  Serial.print(" transactions");
+  if (battery.getLastError() != BQ4050_ERROR_NONE) {
+    Serial.print(" [");
+    Serial.print(BQ4050::getErrorString(battery.getLastError()));
+    Serial.print("]");
+  }
+  Serial.println();
+}
+
+#define BENCHMARK(name, call) do { \
+    uint32_t startUs = micros(); \
+    uint32_t startTransactions = simulator.getTransactionCount(); \
+    call; \
+    report(name, startUs, startTransactions); \
+  } while (0)
+
+void setup() {
+  Serial.begin(115200);
+  Serial.println("BQ4050 Simulator Benchmark");
+  Serial.println("==========================");
+
+  // Model a 100kHz bus and the gauge's MAC processing time
+  simulator.setClock(100000);
+  simulator.setMACLatency(5000);
+  simulator.setSecurityMode(BQ4050_SECURITY_UNSEALED);
+  simulator.setCellVoltage(1, 3710);
+  simulator.setCellVoltage(2, 3695);
+  simulator.setCellVoltage(3, 3702);
+  simulator.setCellVoltage(4, 3688);
+  simulator.setCurrent(-1250);
+
+  if (!battery.begin()) {
+    Serial.println("Failed to initialize simulated BQ4050!");
+    while (1) delay(1000);
+  }
+}
+
+void loop() {
+  BENCHMARK("getVoltage", battery.getVoltage());
+  BENCHMARK("getFirmwareVersion", battery.getFirmwareVersion());
+  BENCHMARK("getCompleteBatteryStatus", battery.getCompleteBatteryStatus());
+  BENCHMARK("readSnapshot(SNAPSHOT_ALL)", battery.readSnapshot(SNAPSHOT_ALL));
+  BENCHMARK("getAllCellStatus", battery.getAllCellStatus());
+  BENCHMARK("getAllTemperatures", battery.getAllTemperatures());
+  BENCHMARK("getStatusSnapshot", battery.getStatusSnapshot());
+  BENCHMARK("getCEDVConfig", battery.getCEDVConfig());
+  BENCHMARK("backupConfiguration", battery.backupConfiguration());
+
+  Serial.println();
+  delay(5000);
+}
@@ -0,0 +1,349 @@
+// Host regression checks: the driver against BQ4050Simulator.
+//
+// Each check builds a fresh simulator and gauge, so they are independent and
+// can run in any order. A failed CHECK prints its location and the run exits
+// non-zero for ctest.
+#include "BQ4050.h"
+#include "BQ4050Manager.h"
+#include "BQ4050Simulator.h"
+
+static int failures = 0;
+
+#define CHECK(condition)                                                        \
+  do {                                                                          \
+    if (!(condition)) {                                                         \
+      printf("  FAIL %s:%d: %s\n", __FILE__, __LINE__, #condition);            \
+      failures++;                                                               \
+    }                                                                           \
+  } while (0)
+
+// Simulator without modelled wire time, so checks do not depend on the bus clock
+static void prepare(BQ4050Simulator& sim, BQ4050_SecurityMode mode) {
+  sim.setWireTimeEnabled(false);
+  sim.setMACLatency(500);
+  sim.setSecurityMode(mode);
+}
+
+static void setMACDelay(BQ4050& gauge, uint16_t macDelayUs) {
+  TimingProfile profile = gauge.getTimingProfile();
+  profile.macDelayUs = macDelayUs;
+  profile.checksum = profile.computeChecksum();
+  CHECK(gauge.setTimingProfile(profile));
+}
+
+static void pecRoundTrip() {
+  BQ4050Simulator sim;
+  prepare(sim, BQ4050_SECURITY_UNSEALED);
+  BQ4050 gauge(sim);
+  CHECK(gauge.begin());
+  gauge.setPECEnabled(true);
+
+  // Writes carry PEC the gauge accepts; reads validate the gauge's PEC
+  CHECK(gauge.setBatteryMode(0x6001));
+  CHECK(sim.getPECErrorCount() == 0);
+  CHECK(gauge.getBatteryMode() == 0x6001);
+  CHECK(gauge.getLastError() == BQ4050_ERROR_NONE);
+
+  // A corrupted frame is caught and the read repeated
+  uint32_t recovered = gauge.getRetryStats().recovered;
+  sim.corruptNextPEC();
+  CHECK(gauge.getBatteryMode() == 0x6001);
+  CHECK(gauge.getLastError() == BQ4050_ERROR_NONE);
+  CHECK(gauge.getRetryStats().recovered == recovered + 1);
+
+  // Without retries the mismatch surfaces
+  RetryPolicy policy = gauge.getRetryPolicy();
+  policy.maxAttempts = 1;
+  gauge.setRetryPolicy(policy);
+  sim.corruptNextPEC();
+  gauge.getBatteryMode();
+  CHECK(gauge.getLastError() == BQ4050_ERROR_PEC_MISMATCH);
+}
+
+static void sealedAccess() {
+  BQ4050Simulator sim;
+  prepare(sim, BQ4050_SECURITY_SEALED);
+  sim.setCellVoltage(1, 3710);
+  sim.setStatus(BQ4050_CMD_SAFETY_STATUS, 0x00021234);
+  BQ4050 gauge(sim);
+  CHECK(gauge.begin());
+
+  // The gauge NACKs unsealed-only SBS commands...
+  uint8_t command = BQ4050_CMD_DA_STATUS_1;
+  uint8_t response[34];
+  uint8_t received = 0;
+  CHECK(sim.writeRead(0x0B, &command, 1, response, sizeof(response), received) == BQ4050_TRANSPORT_DATA_NACK);
+
+  // ...which the driver refuses up front once it knows the mode
+  CHECK(gauge.getSecurityMode() == BQ4050_SECURITY_SEALED);
+  gauge.getDAStatus1();
+  CHECK(gauge.getLastError() == BQ4050_ERROR_ACCESS_DENIED);
+  gauge.readDataFlash(0x4000);
+  CHECK(gauge.getLastError() == BQ4050_ERROR_ACCESS_DENIED);
+
+  // Status and DAStatus still arrive through their MAC mirrors
+  CHECK(gauge.getSafetyStatus() == 0x1234);
+  CHECK(gauge.getStatusSnapshot().safetyStatus == 0x00021234);
+  CellStatus cells = gauge.getAllCellStatus();
+  CHECK(gauge.getLastError() == BQ4050_ERROR_NONE);
+  CHECK(cells.voltage1 > 3.70f && cells.voltage1 < 3.72f);
+
+  CHECK(gauge.unsealDevice());
+  CHECK(gauge.getSecurityMode() == BQ4050_SECURITY_UNSEALED);
+  gauge.getDAStatus1();
+  CHECK(gauge.getLastError() == BQ4050_ERROR_NONE);
+}
+
+static void dataFlashBlocks() {
+  BQ4050Simulator sim;
+  prepare(sim, BQ4050_SECURITY_UNSEALED);
+  BQ4050 gauge(sim);
+  CHECK(gauge.begin());
+
+  // 70 bytes span three ManufacturerBlockAccess writes and reads
+  uint8_t written[70];
+  uint8_t readBack[70];
+  for (uint8_t i = 0; i < sizeof(written); i++) {
+    written[i] = i * 7 + 3;
+  }
+  CHECK(gauge.writeDataFlashBlock(0x4410, written, sizeof(written)));
+  CHECK(memcmp(sim.getDataFlash() + 0x410, written, sizeof(written)) == 0);
+  CHECK(gauge.readDataFlashBlock(0x4410, readBack, sizeof(readBack)));
+  CHECK(memcmp(readBack, written, sizeof(written)) == 0);
+
+  // Same with PEC on both directions
+  gauge.setPECEnabled(true);
+  written[0] ^= 0xFF;
+  CHECK(gauge.writeDataFlashBlock(0x4410, written, sizeof(written)));
+  CHECK(gauge.readDataFlashBlock(0x4410, readBack, sizeof(readBack)));
+  CHECK(memcmp(readBack, written, sizeof(written)) == 0);
+  CHECK(sim.getPECErrorCount() == 0);
+
+  // Out-of-range addresses never reach the bus
+  CHECK(!gauge.writeDataFlash(0x6000, 0));
+  CHECK(gauge.getLastError() == BQ4050_ERROR_INVALID_PARAMETER);
+
+  // A transmit buffer with no room for data is refused rather than wrapped
+  uint32_t transactions = sim.getTransactionCount();
+  sim.setMaxTransferLength(5);
+  CHECK(!gauge.writeDataFlash(0x4400, 0));
+  CHECK(gauge.getLastError() == BQ4050_ERROR_INVALID_PARAMETER);
+  CHECK(sim.getTransactionCount() == transactions);
+}
+
+static void dataFlashCacheFailedCommit() {
+  BQ4050Simulator sim;
+  prepare(sim, BQ4050_SECURITY_UNSEALED);
+  BQ4050 gauge(sim);
+  CHECK(gauge.begin());
+  RetryPolicy policy = gauge.getRetryPolicy();
+  policy.maxAttempts = 1;
+  gauge.setRetryPolicy(policy);
+
+  gauge.enableDataFlashCache(true);
+  CHECK(gauge.writeDataFlash(0x4400, 0x5A));
+  sim.failNextTransactions(1);
+  CHECK(!gauge.commit());
+  CHECK(gauge.hasUncommittedChanges());   // Still pending, not silently clean
+
+  // Neither invalidating nor a refused disable may drop the pending byte
+  gauge.invalidateDataFlashCache();
+  CHECK(gauge.hasUncommittedChanges());
+  sim.failNextTransactions(1);
+  gauge.enableDataFlashCache(false);
+  CHECK(gauge.isDataFlashCacheEnabled());
+  CHECK(gauge.hasUncommittedChanges());
+  CHECK(gauge.commit());
+  CHECK(!gauge.hasUncommittedChanges());
+  CHECK(sim.getDataFlash()[0x400] == 0x5A);
+}
+
+static void dataFlashBatchFailedFlush() {
+  BQ4050Simulator sim;
+  prepare(sim, BQ4050_SECURITY_UNSEALED);
+  BQ4050 gauge(sim);
+  CHECK(gauge.begin());
+  RetryPolicy policy = gauge.getRetryPolicy();
+  policy.maxAttempts = 1;
+  gauge.setRetryPolicy(policy);
+
+  // Two runs; the first block write fails, the second lands
+  gauge.beginDataFlashBatch();
+  CHECK(gauge.writeDataFlash(0x4400, 0x11));
+  CHECK(gauge.writeDataFlash(0x4401, 0x22));
+  CHECK(gauge.writeDataFlash(0x4420, 0x33));
+  sim.failNextTransactions(1);
+  CHECK(!gauge.commitDataFlashBatch());
+  CHECK(sim.getDataFlash()[0x420] == 0x33);
+  CHECK(sim.getDataFlash()[0x400] != 0x11);
+
+  // Later writes queue behind the failed run, and the retry programs both
+  CHECK(gauge.writeDataFlash(0x4402, 0x44));
+  CHECK(sim.getDataFlash()[0x402] != 0x44);
+  CHECK(gauge.commitDataFlashBatch());
+  CHECK(sim.getDataFlash()[0x400] == 0x11);
+  CHECK(sim.getDataFlash()[0x401] == 0x22);
+  CHECK(sim.getDataFlash()[0x402] == 0x44);
+
+  // Nothing left to retry
+  CHECK(!gauge.commitDataFlashBatch());
+  CHECK(gauge.getLastError() == BQ4050_ERROR_INVALID_PARAMETER);
+}
+
+static void snapshotFields() {
+  BQ4050Simulator sim;
+  prepare(sim, BQ4050_SECURITY_UNSEALED);
+  for (uint8_t cell = 1; cell <= 4; cell++) {
+    sim.setCellVoltage(cell, 3700);
+  }
+  sim.setRegister(BQ4050_CMD_VOLTAGE, 14600);   // Not the cell sum, as on a BAT-sensing pack
+  BQ4050 gauge(sim);
+  CHECK(gauge.begin());
+
+  uint32_t fields = SNAPSHOT_CELL_VOLTAGES | SNAPSHOT_VOLTAGE | SNAPSHOT_CURRENT;
+  BatterySnapshot snapshot = gauge.readSnapshot(fields);
+  CHECK(snapshot.fields == fields);
+  CHECK(snapshot.voltage > 14.59f && snapshot.voltage < 14.61f);
+  CHECK(snapshot.cellVoltage[3] > 3.69f && snapshot.cellVoltage[3] < 3.71f);
+
+  // Transactions match what crossed the bus, sealed MAC-mirror reads included
+  fields |= SNAPSHOT_SAFETY_STATUS;
+  uint32_t before = sim.getTransactionCount();
+  snapshot = gauge.readSnapshot(fields);
+  CHECK(snapshot.fields == fields);
+  CHECK(snapshot.transactions == sim.getTransactionCount() - before);
+
+  CHECK(gauge.sealDevice());
+  before = sim.getTransactionCount();
+  snapshot = gauge.readSnapshot(fields);
+  CHECK(snapshot.fields == fields);
+  CHECK(snapshot.transactions == sim.getTransactionCount() - before);
+  CHECK(snapshot.transactions >= 6);   // Three words, then a 0x44 write and read per mirror
+}
+
+static void managerSweep() {
+  BQ4050Simulator simA, simB;
+  prepare(simA, BQ4050_SECURITY_UNSEALED);
+  prepare(simB, BQ4050_SECURITY_UNSEALED);
+  BQ4050 packA(simA), packB(simB);
+  BQ4050Manager manager;
+  CHECK(manager.addGauge(packA) == 0);
+  CHECK(manager.addGauge(packB) == 1);
+  CHECK(manager.beginAll());
+  RetryPolicy policy = packB.getRetryPolicy();
+  policy.maxAttempts = 1;
+  packB.setRetryPolicy(policy);
+
+  // Pack B loses its first read but ends on a good one; it still did not succeed
+  BatterySnapshot snapshots[2];
+  simB.failNextTransactions(1);
+  CHECK(manager.sweep(SNAPSHOT_BASIC, snapshots) == 1);
+  CHECK(snapshots[0].fields == SNAPSHOT_BASIC);
+  CHECK(snapshots[1].fields != SNAPSHOT_BASIC);
+  CHECK(packB.getLastError() == BQ4050_ERROR_NONE);
+
+  CHECK(manager.sweep(SNAPSHOT_BASIC, snapshots) == 2);
+}
+
+static void macLatency() {
+  BQ4050Simulator sim;
+  prepare(sim, BQ4050_SECURITY_UNSEALED);
+  sim.setMACLatency(2000);
+  BQ4050 gauge(sim);
+  gauge.setIdentityCacheEnabled(false);
+  CHECK(gauge.begin());
+
+  // Waiting long enough gives the result, and takes at least the latency
+  uint32_t start = micros();
+  CHECK(gauge.getDeviceType() == 0x4050);
+  CHECK(micros() - start >= 2000);
+
+  // Reading too early returns the previous command's result, as the gauge does
+  setMACDelay(gauge, 500);
+  CHECK(gauge.getHardwareVersion() == 0x4050);
+
+  // Calibration settles just above the real latency
+  CHECK(gauge.calibrateTiming());
+  uint16_t macDelayUs = gauge.getTimingProfile().macDelayUs;
+  CHECK(macDelayUs >= 2000 && macDelayUs <= 3200);
+  CHECK(gauge.getHardwareVersion() == 0x0000);
+}
+
+static void pollerShadow() {
+  BQ4050Simulator sim;
+  prepare(sim, BQ4050_SECURITY_UNSEALED);
+  sim.setRegister(BQ4050_CMD_VOLTAGE, 14000);
+  BQ4050 gauge(sim);
+  CHECK(gauge.begin());
+
+  CHECK(gauge.pollRegister(BQ4050_CMD_VOLTAGE, 1000, 20));
+  CHECK(gauge.tick() == 1);
+  CHECK(gauge.tick() == 0);   // Not due again for a second
+
+  // Fresh shadow: the getter answers without a transaction, even once the gauge moved
+  sim.setRegister(BQ4050_CMD_VOLTAGE, 15000);
+  uint32_t before = sim.getTransactionCount();
+  CHECK(gauge.getVoltage() > 13.99f && gauge.getVoltage() < 14.01f);
+  CHECK(sim.getTransactionCount() == before);
+
+  // Past its max age the getter reads the bus and refreshes the shadow
+  delay(30);
+  CHECK(gauge.getVoltage() > 14.99f && gauge.getVoltage() < 15.01f);
+  CHECK(sim.getTransactionCount() == before + 1);
+  CHECK(gauge.getShadowAge(BQ4050_CMD_VOLTAGE) < 20);
+
+  // Unpolled registers always go to the bus
+  CHECK(gauge.unpollRegister(BQ4050_CMD_VOLTAGE));
+  CHECK(gauge.getShadowAge(BQ4050_CMD_VOLTAGE) == BQ4050::SHADOW_AGE_NEVER);
+  before = sim.getTransactionCount();
+  gauge.getVoltage();
+  CHECK(sim.getTransactionCount() == before + 1);
+}
+
+static void autotuneWithPolling() {
+  BQ4050Simulator sim;
+  prepare(sim, BQ4050_SECURITY_UNSEALED);
+  sim.setStatus(BQ4050_CMD_OPERATION_STATUS, 0x00400000);   // XL: 400 kHz allowed
+  sim.setMaxReliableClock(100000);
+  BQ4050 gauge(sim);
+  CHECK(gauge.begin());
+
+  // Fresh shadows must not stand in for the PEC-checked verify reads
+  CHECK(gauge.pollRegister(BQ4050_CMD_VOLTAGE, 1000));
+  CHECK(gauge.pollRegister(BQ4050_CMD_TEMPERATURE, 1000));
+  CHECK(gauge.pollRegister(BQ4050_CMD_CURRENT, 1000));
+  CHECK(gauge.tick() == 3);
+  CHECK(gauge.autotuneBusSpeed(400000) == 100000);
+  CHECK(gauge.getBusFrequency() == 100000);
+
+  // A limit below the 50 kHz base rate is refused, never exceeded
+  CHECK(gauge.autotuneBusSpeed(40000) == 0);
+  CHECK(gauge.getLastError() == BQ4050_ERROR_INVALID_PARAMETER);
+  CHECK(gauge.getBusFrequency() == 100000);
+}
+
+int main() {
+  struct {
+    const char* name;
+    void (*run)();
+  } checks[] = {
+    {"PEC round trip", pecRoundTrip},
+    {"sealed access", sealedAccess},
+    {"data flash blocks", dataFlashBlocks},
+    {"data flash cache failed commit", dataFlashCacheFailedCommit},
+    {"data flash batch failed flush", dataFlashBatchFailedFlush},
+    {"snapshot fields", snapshotFields},
+    {"manager sweep", managerSweep},
+    {"MAC latency", macLatency},
+    {"poller shadow", pollerShadow},
+    {"autotune with polled registers", autotuneWithPolling},
+  };
+
+  for (size_t i = 0; i < sizeof(checks) / sizeof(checks[0]); i++) {
+    int before = failures;
+    checks[i].run();
+    printf("%s %s\n", failures == before ? "ok  " : "FAIL", checks[i].name);
+  }
+  printf("%d failure(s)\n", failures);
+  return failures == 0 ? 0 : 1;
+}
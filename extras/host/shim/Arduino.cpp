@@ -0,0 +1,37 @@
+#include <Arduino.h>
+#include <Wire.h>
+
+#include <chrono>
+#include <thread>
+
+HardwareSerial Serial;
+TwoWire Wire;
+
+namespace {
+  const std::chrono::steady_clock::time_point START = std::chrono::steady_clock::now();
+}
+
+unsigned long micros() {
+  return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - START).count();
+}
+
+unsigned long millis() {
+  return micros() / 1000;
+}
+
+void delay(unsigned long ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(unsigned int us) {
+  std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+int Print::printf(const char* pattern, ...) {
+  va_list args;
+  va_start(args, pattern);
+  int written = vprintf(pattern, args);
+  va_end(args);
+  return written;
+}
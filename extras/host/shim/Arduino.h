@@ -0,0 +1,129 @@
+// Minimal Arduino core for building the library on a Linux host.
+//
+// Covers what src/ uses and nothing more: timing, pin stubs, String and Print.
+// Serial writes to stdout. Pins read back HIGH (an idle bus) and interrupts are
+// no-ops, so the Wire backend's recovery paths run without hardware.
+#ifndef BQ4050_HOST_ARDUINO_H
+#define BQ4050_HOST_ARDUINO_H
+
+#include <ctype.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+#define F(x) x
+#define PROGMEM
+#define pgm_read_byte(address) (*(const uint8_t*)(address))
+
+#define HEX 16
+#define DEC 10
+
+#define LOW 0
+#define HIGH 1
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+
+typedef uint8_t byte;
+
+unsigned long micros();
+unsigned long millis();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+inline void yield() {}
+inline void noInterrupts() {}
+inline void interrupts() {}
+inline void pinMode(int, int) {}
+inline void digitalWrite(int, int) {}
+inline int digitalRead(int) { return HIGH; }
+
+class String {
+public:
+  String() {}
+  String(const char* text) : _text(text ? text : "") {}
+  String(char c) : _text(1, c) {}
+  String(int value, int base = DEC) { format(base == HEX ? "%x" : "%d", value); }
+  String(unsigned int value, int base = DEC) { format(base == HEX ? "%x" : "%u", value); }
+  String(long value, int base = DEC) { format(base == HEX ? "%lx" : "%ld", value); }
+  String(unsigned long value, int base = DEC) { format(base == HEX ? "%lx" : "%lu", value); }
+  String(double value, int decimals = 2) { format("%.*f", decimals, value); }
+
+  unsigned int length() const { return _text.size(); }
+  const char* c_str() const { return _text.c_str(); }
+  void reserve(unsigned int size) { _text.reserve(size); }
+  char operator[](unsigned int index) const { return _text[index]; }
+  char& operator[](unsigned int index) { return _text[index]; }
+
+  String& operator+=(const String& other) { _text += other._text; return *this; }
+  String& operator+=(const char* other) { _text += other; return *this; }
+  String& operator+=(char c) { _text += c; return *this; }
+  friend String operator+(const String& a, const String& b) { return String(a._text + b._text); }
+  friend String operator+(const String& a, const char* b) { return String(a._text + b); }
+  friend String operator+(const char* a, const String& b) { return String(a + b._text); }
+  bool operator==(const String& other) const { return _text == other._text; }
+  bool operator==(const char* other) const { return _text == other; }
+  bool operator!=(const String& other) const { return _text != other._text; }
+
+  int indexOf(const char* needle) const {
+    size_t position = _text.find(needle);
+    return position == std::string::npos ? -1 : (int)position;
+  }
+  int indexOf(const String& needle) const { return indexOf(needle.c_str()); }
+  bool startsWith(const String& prefix) const { return _text.compare(0, prefix._text.size(), prefix._text) == 0; }
+  String substring(unsigned int from) const { return String(_text.substr(from)); }
+  String substring(unsigned int from, unsigned int to) const { return String(_text.substr(from, to - from)); }
+  void toUpperCase() { for (size_t i = 0; i < _text.size(); i++) _text[i] = toupper(_text[i]); }
+  void trim() {
+    size_t first = _text.find_first_not_of(" \t\r\n");
+    size_t last = _text.find_last_not_of(" \t\r\n");
+    _text = (first == std::string::npos) ? std::string() : _text.substr(first, last - first + 1);
+  }
+  long toInt() const { return atol(_text.c_str()); }
+
+private:
+  std::string _text;
+
+  explicit String(const std::string& text) : _text(text) {}
+  void format(const char* pattern, ...) {
+    char buffer[64];
+    va_list args;
+    va_start(args, pattern);
+    vsnprintf(buffer, sizeof(buffer), pattern, args);
+    va_end(args);
+    _text = buffer;
+  }
+};
+
+class Print {
+public:
+  virtual ~Print() {}
+
+  size_t print(const String& value) { return fputs(value.c_str(), stdout) >= 0 ? value.length() : 0; }
+  size_t print(const char* value) { return print(String(value)); }
+  size_t print(char value) { return print(String(value)); }
+  size_t print(double value, int decimals = 2) { return print(String(value, decimals)); }
+  size_t print(int value, int base = DEC) { return print(String(value, base)); }
+  size_t print(unsigned int value, int base = DEC) { return print(String(value, base)); }
+  size_t print(long value, int base = DEC) { return print(String(value, base)); }
+  size_t print(unsigned long value, int base = DEC) { return print(String(value, base)); }
+  size_t println() { return print("\n"); }
+  template <typename T> size_t println(const T& value) { return print(value) + println(); }
+  template <typename T> size_t println(const T& value, int format) { return print(value, format) + println(); }
+  int printf(const char* pattern, ...) __attribute__((format(printf, 2, 3)));
+};
+
+class HardwareSerial : public Print {
+public:
+  void begin(unsigned long) {}
+  int available() { return 0; }
+  int read() { return -1; }
+  operator bool() const { return true; }
+};
+
+extern HardwareSerial Serial;
+
+#endif
@@ -0,0 +1,29 @@
+// Host stand-in for the Arduino Wire library. There is no bus on the build
+// machine: every transmission is address-NACKed, so a BQ4050 on the default
+// Wire transport fails the way an empty bus would. Tests plug in
+// BQ4050Simulator (or another BQ4050Transport) instead.
+#ifndef BQ4050_HOST_WIRE_H
+#define BQ4050_HOST_WIRE_H
+
+#include <Arduino.h>
+
+#define BUFFER_LENGTH 32
+
+class TwoWire {
+public:
+  void begin() {}
+  void begin(int, int) {}
+  void end() {}
+  void setClock(uint32_t) {}
+  void beginTransmission(uint8_t) {}
+  size_t write(uint8_t) { return 1; }
+  size_t write(const uint8_t*, size_t length) { return length; }
+  uint8_t endTransmission(bool = true) { return 2; }
+  uint8_t requestFrom(uint8_t, uint8_t) { return 0; }
+  int available() { return 0; }
+  int read() { return -1; }
+};
+
+extern TwoWire Wire;
+
+#endif
@@ -1,14 +1,93 @@
 #include "BQ4050.h"
 
+// SMBus PEC: CRC-8, polynomial x^8 + x^2 + x + 1. The table lives in flash
+// (PROGMEM) so AVR boards do not copy it into RAM.
+static const uint8_t CRC8_TABLE[256] PROGMEM = {
+  0x00, 0x07, 0x0E, 0x09, 0x1C, 0x1B, 0x12, 0x15, 0x38, 0x3F, 0x36, 0x31, 0x24, 0x23, 0x2A, 0x2D,
+  0x70, 0x77, 0x7E, 0x79, 0x6C, 0x6B, 0x62, 0x65, 0x48, 0x4F, 0x46, 0x41, 0x54, 0x53, 0x5A, 0x5D,
+  0xE0, 0xE7, 0xEE, 0xE9, 0xFC, 0xFB, 0xF2, 0xF5, 0xD8, 0xDF, 0xD6, 0xD1, 0xC4, 0xC3, 0xCA, 0xCD,
+  0x90, 0x97, 0x9E, 0x99, 0x8C, 0x8B, 0x82, 0x85, 0xA8, 0xAF, 0xA6, 0xA1, 0xB4, 0xB3, 0xBA, 0xBD,
+  0xC7, 0xC0, 0xC9, 0xCE, 0xDB, 0xDC, 0xD5, 0xD2, 0xFF, 0xF8, 0xF1, 0xF6, 0xE3, 0xE4, 0xED, 0xEA,
+  0xB7, 0xB0, 0xB9, 0xBE, 0xAB, 0xAC, 0xA5, 0xA2, 0x8F, 0x88, 0x81, 0x86, 0x93, 0x94, 0x9D, 0x9A,
+  0x27, 0x20, 0x29, 0x2E, 0x3B, 0x3C, 0x35, 0x32, 0x1F, 0x18, 0x11, 0x16, 0x03, 0x04, 0x0D, 0x0A,
+  0x57, 0x50, 0x59, 0x5E, 0x4B, 0x4C, 0x45, 0x42, 0x6F, 0x68, 0x61, 0x66, 0x73, 0x74, 0x7D, 0x7A,
+  0x89, 0x8E, 0x87, 0x80, 0x95, 0x92, 0x9B, 0x9C, 0xB1, 0xB6, 0xBF, 0xB8, 0xAD, 0xAA, 0xA3, 0xA4,
+  0xF9, 0xFE, 0xF7, 0xF0, 0xE5, 0xE2, 0xEB, 0xEC, 0xC1, 0xC6, 0xCF, 0xC8, 0xDD, 0xDA, 0xD3, 0xD4,
+  0x69, 0x6E, 0x67, 0x60, 0x75, 0x72, 0x7B, 0x7C, 0x51, 0x56, 0x5F, 0x58, 0x4D, 0x4A, 0x43, 0x44,
+  0x19, 0x1E, 0x17, 0x10, 0x05, 0x02, 0x0B, 0x0C, 0x21, 0x26, 0x2F, 0x28, 0x3D, 0x3A, 0x33, 0x34,
+  0x4E, 0x49, 0x40, 0x47, 0x52, 0x55, 0x5C, 0x5B, 0x76, 0x71, 0x78, 0x7F, 0x6A, 0x6D, 0x64, 0x63,
+  0x3E, 0x39, 0x30, 0x37, 0x22, 0x25, 0x2C, 0x2B, 0x06, 0x01, 0x08, 0x0F, 0x1A, 0x1D, 0x14, 0x13,
+  0xAE, 0xA9, 0xA0, 0xA7, 0xB2, 0xB5, 0xBC, 0xBB, 0x96, 0x91, 0x98, 0x9F, 0x8A, 0x8D, 0x84, 0x83,
+  0xDE, 0xD9, 0xD0, 0xD7, 0xC2, 0xC5, 0xCC, 0xCB, 0xE6, 0xE1, 0xE8, 0xEF, 0xFA, 0xFD, 0xF4, 0xF3
+};
+
+static inline uint8_t crc8Update(uint8_t crc, uint8_t data) {
+  return pgm_read_byte(&CRC8_TABLE[crc ^ data]);
+}
+
 BQ4050::BQ4050(uint8_t address, TwoWire& wire)
-  : _address(address), _wire(&wire), _lastError(BQ4050_ERROR_NONE), _pecEnabled(false) {
+  : _address(address), _wireTransport(wire), _transport(&_wireTransport),
+    _lastError(BQ4050_ERROR_NONE), _pecEnabled(false),
+    _macCommand(0), _macStartUs(0), _macState(BQ4050_MAC_STATE_IDLE),
+    _responseDelayUs(I2C_RESPONSE_DELAY_US), _macDelayUs(MAC_PROCESSING_DELAY_US), _calibrateOnBegin(false),
+    _busFrequency(0), _busFallback(false), _busWindowCount(0), _busWindowErrors(0),
+    _identityCacheEnabled(true), _identityOperationStatus(OPERATION_STATUS_UNKNOWN),
+    _busLock(nullptr), _busLockTimeoutMs(100), _busLockDepth(0), _macLockHeld(false),
+    _sentinelRuleCount(0), _retrySeed(0x2545F491), _lastTransportStatus(BQ4050_TRANSPORT_OK), _transferCount(0),
+    _dfBatchCount(0), _dfBatchDepth(0), _dfProgramUs(0), _dfProgramPending(false), _shadowCount(0), _dfCacheEnabled(false), _dfCacheClock(0),
+    _lastSecurityMode(BQ4050_SECURITY_UNKNOWN) {
+  _pecAddressCRC = crc8Update(0x00, (uint8_t)(_address << 1));
+  discardDataFlashChanges();
+  invalidateIdentity();
+  clearPolling();
+  resetRetryPolicy();
+  resetRetryStats();
+#ifdef BQ4050_BUS_STATS
+  _busScopeDepth = 0;
+  resetBusStats();
+#endif
+#ifdef BQ4050_LATENCY_STATS
+  resetLatencyHistograms();
+#endif
+}
+
+BQ4050::BQ4050(BQ4050Transport& transport, uint8_t address)
+  : _address(address), _wireTransport(Wire), _transport(&transport),
+    _lastError(BQ4050_ERROR_NONE), _pecEnabled(false),
+    _macCommand(0), _macStartUs(0), _macState(BQ4050_MAC_STATE_IDLE),
+    _responseDelayUs(I2C_RESPONSE_DELAY_US), _macDelayUs(MAC_PROCESSING_DELAY_US), _calibrateOnBegin(false),
+    _busFrequency(0), _busFallback(false), _busWindowCount(0), _busWindowErrors(0),
+    _identityCacheEnabled(true), _identityOperationStatus(OPERATION_STATUS_UNKNOWN),
+    _busLock(nullptr), _busLockTimeoutMs(100), _busLockDepth(0), _macLockHeld(false),
+    _sentinelRuleCount(0), _retrySeed(0x2545F491), _lastTransportStatus(BQ4050_TRANSPORT_OK), _transferCount(0),
+    _dfBatchCount(0), _dfBatchDepth(0), _dfProgramUs(0), _dfProgramPending(false), _shadowCount(0), _dfCacheEnabled(false), _dfCacheClock(0),
+    _lastSecurityMode(BQ4050_SECURITY_UNKNOWN) {
+  _pecAddressCRC = crc8Update(0x00, (uint8_t)(_address << 1));
+  discardDataFlashChanges();
+  invalidateIdentity();
+  clearPolling();
+  resetRetryPolicy();
+  resetRetryStats();
+#ifdef BQ4050_BUS_STATS
+  _busScopeDepth = 0;
+  resetBusStats();
+#endif
+#ifdef BQ4050_LATENCY_STATS
+  resetLatencyHistograms();
+#endif
 }
 
 bool BQ4050::begin() {
+  BQ4050_BUS_SCOPE();
   BQ4050_DEBUG_BEGIN();
-  _wire->begin();
+  if (!_transport->begin()) {
+    BQ4050_DEBUG_PRINT("Transport failed to start");
+    setError(BQ4050_ERROR_I2C_TIMEOUT);
+    return false;
+  }
 
   // Test communication by reading device type
+  invalidateIdentity();
   uint16_t deviceType = getDeviceType();
   if (_lastError != BQ4050_ERROR_NONE) {
     BQ4050_DEBUG_PRINTF("Initialization failed: %s", getErrorString(_lastError).c_str());
@@ -16,33 +95,56 @@ bool BQ4050::begin() {
   }
 
   BQ4050_DEBUG_HEX("Device Type", deviceType);
+  if (_calibrateOnBegin && !calibrateTiming()) {
+    return false;
+  }
+  fillIdentity();
   BQ4050_DEBUG_PRINT("Initialization successful");
   return true;
 }
 
 bool BQ4050::begin(TwoWire& wire) {
-  _wire = &wire;
+  BQ4050_BUS_SCOPE();
+  _wireTransport.setWire(wire);
+  _transport = &_wireTransport;
+  return begin();
+}
+
+bool BQ4050::begin(BQ4050Transport& transport) {
+  BQ4050_BUS_SCOPE();
+  _transport = &transport;
   return begin();
 }
 
 bool BQ4050::begin(int sda, int scl) {
-  _wire->begin(sda, scl);
+  BQ4050_BUS_SCOPE();
+  _transport = &_wireTransport;
+  _wireTransport.begin(sda, scl);
   
   // Test communication by reading device type
+  invalidateIdentity();
   uint16_t deviceType = getDeviceType();
   if (_lastError != BQ4050_ERROR_NONE) {
     return false;
   }
 
   BQ4050_DEBUG_HEX("Device Type", deviceType);
+  if (_calibrateOnBegin && !calibrateTiming()) {
+    return false;
+  }
+  fillIdentity();
   return true;
 }
 
 bool BQ4050::begin(int sda, int scl, uint32_t frequency) {
-  _wire->begin(sda, scl);
-  _wire->setClock(frequency);
+  BQ4050_BUS_SCOPE();
+  _transport = &_wireTransport;
+  _wireTransport.begin(sda, scl);
+  _wireTransport.setClock(frequency);
+  _busFrequency = frequency;
   
   // Test communication by reading device type  
+  invalidateIdentity();
   uint16_t deviceType = getDeviceType();
   if (_lastError != BQ4050_ERROR_NONE) {
     return false;
@@ -50,189 +152,1532 @@ bool BQ4050::begin(int sda, int scl, uint32_t frequency) {
 
   BQ4050_DEBUG_PRINTF("Initialized with %uHz", frequency);
   BQ4050_DEBUG_HEX("Device Type", deviceType);
+  if (_calibrateOnBegin && !calibrateTiming()) {
+    return false;
+  }
+  fillIdentity();
   return true;
 }
 
-// Enhanced I2C helper methods
-bool BQ4050::safeBeginTransmission(uint8_t reg) {
-  _wire->beginTransmission(_address);
-  _wire->write(reg);
-  
-  uint8_t result = _wire->endTransmission(false);
-  if (result != 0) {
-    BQ4050_DEBUG_PRINTF("I2C transmission failed: %d", result);
-    setError(BQ4050_ERROR_I2C_NACK);
+// Bus Speed Negotiation
+// SMBus rates tried from the bottom up; 50 kHz is the safe starting point
+static const uint32_t BUS_SPEED_STEPS[] = {50000, 100000, 200000, 300000, 400000};
+static const uint8_t BUS_SPEED_STEP_COUNT = sizeof(BUS_SPEED_STEPS) / sizeof(BUS_SPEED_STEPS[0]);
+
+uint32_t BQ4050::autotuneBusSpeed(uint32_t maxFrequency) {
+  BQ4050_BUS_SCOPE();
+  uint32_t previous = _busFrequency;
+  if (maxFrequency < BUS_SPEED_STEPS[0]) {
+    // Even the base rate would exceed the caller's limit; leave the clock alone
+    setError(BQ4050_ERROR_INVALID_PARAMETER);
+    return 0;
+  }
+
+  // Negotiate on single attempts so a marginal rate cannot pass on retries
+  RetryPolicy policy = _retryPolicy;
+  _retryPolicy.maxAttempts = 1;
+
+  applyBusFrequency(BUS_SPEED_STEPS[0]);
+  uint32_t operationStatus = 0;
+  if (!readOperationStatus(operationStatus) || !verifyBusSpeed()) {
+    BQ4050_DEBUG_PRINT("Bus speed autotune: no reliable base rate");
+    if (previous > 0) {
+      applyBusFrequency(previous);
+    }
+    _retryPolicy = policy;
+    return 0;
+  }
+
+  // Without XL the gauge only guarantees SMBus standard mode
+  uint32_t ceiling = (operationStatus & OPERATION_STATUS_XL) ? 400000 : 100000;
+  if (maxFrequency < ceiling) {
+    ceiling = maxFrequency;
+  }
+  BQ4050_DEBUG_PRINTF("Bus speed autotune: XL=%d, ceiling %lu Hz",
+                      (operationStatus & OPERATION_STATUS_XL) ? 1 : 0, (unsigned long)ceiling);
+
+  uint32_t best = BUS_SPEED_STEPS[0];
+  for (uint8_t i = 1; i < BUS_SPEED_STEP_COUNT && BUS_SPEED_STEPS[i] <= ceiling; i++) {
+    applyBusFrequency(BUS_SPEED_STEPS[i]);
+    if (!verifyBusSpeed()) {
+      BQ4050_DEBUG_PRINTF("Bus speed autotune: %lu Hz failed", (unsigned long)BUS_SPEED_STEPS[i]);
+      break;
+    }
+    best = BUS_SPEED_STEPS[i];
+  }
+
+  applyBusFrequency(best);
+  _retryPolicy = policy;
+  setError(BQ4050_ERROR_NONE);
+  BQ4050_DEBUG_PRINTF("Bus speed autotune: %lu Hz", (unsigned long)best);
+  return best;
+}
+
+void BQ4050::setBusSpeedFallback(bool enable) {
+  _busFallback = enable;
+  _busWindowCount = 0;
+  _busWindowErrors = 0;
+}
+
+uint32_t BQ4050::getBusFrequency() const {
+  return _busFrequency;
+}
+
+bool BQ4050::readOperationStatus(uint32_t& value) {
+  // SBS 0x54 when unsealed; MAC 0x0054 through ManufacturerBlockAccess() otherwise
+  uint8_t block[4];
+  if (readBlock(BQ4050_CMD_OPERATION_STATUS, block, 4) == 4 && _lastError == BQ4050_ERROR_NONE) {
+    value = (uint32_t)block[0] | ((uint32_t)block[1] << 8) | ((uint32_t)block[2] << 16) | ((uint32_t)block[3] << 24);
+    observeOperationStatus(value);
+    return true;
+  }
+
+  if (readMACBlock(BQ4050_MAC_OPERATION_STATUS, block, 4) < 4) {
+    if (_lastError == BQ4050_ERROR_NONE) {
+      setError(BQ4050_ERROR_UNEXPECTED_RESPONSE);
+    }
     return false;
   }
-  
-  // Add response delay for device to prepare data
-  delayMicroseconds(I2C_RESPONSE_DELAY_US);
+  value = (uint32_t)block[0] | ((uint32_t)block[1] << 8) | ((uint32_t)block[2] << 16) | ((uint32_t)block[3] << 24);
+  observeOperationStatus(value);
   return true;
 }
 
-uint8_t BQ4050::safeRequestData(uint8_t bytesToRead) {
-  uint8_t bytesReceived = _wire->requestFrom(_address, bytesToRead);
-  if (bytesReceived != bytesToRead) {
-    BQ4050_DEBUG_PRINTF("I2C request failed: wanted %d, got %d", bytesToRead, bytesReceived);
-    setError(BQ4050_ERROR_I2C_TIMEOUT);
-    return 0;
+bool BQ4050::verifyBusSpeed() {
+  // Voltage, Temperature and Current change between reads, so PEC is the only
+  // meaningful check; it is forced on for the test whatever the user setting
+  static const uint8_t registers[] = {BQ4050_CMD_VOLTAGE, BQ4050_CMD_TEMPERATURE, BQ4050_CMD_CURRENT};
+  bool pecEnabled = _pecEnabled;
+  _pecEnabled = true;
+
+  bool ok = true;
+  for (uint8_t i = 0; i < BUS_TUNE_READS && ok; i++) {
+    fetchRegister16(registers[i % sizeof(registers)]);  // Never the poller shadow
+    ok = (_lastError == BQ4050_ERROR_NONE);
   }
-  return bytesReceived;
+
+  _pecEnabled = pecEnabled;
+  return ok;
 }
 
-// Private I2C Communication Methods
-uint8_t BQ4050::readRegister8(uint8_t reg) {
-  if (!safeBeginTransmission(reg)) {
-    return 0;
-  }
+void BQ4050::applyBusFrequency(uint32_t frequency) {
+  _transport->setClock(frequency);
+  _busFrequency = frequency;
+  _busWindowCount = 0;
+  _busWindowErrors = 0;
+}
 
-  uint8_t bytesToRead = _pecEnabled ? 2 : 1; // +1 for PEC if enabled
-  if (safeRequestData(bytesToRead) == 0) {
-    return 0;
+void BQ4050::trackBusHealth(bool ok) {
+  if (!_busFallback || _busFrequency <= BUS_SPEED_STEPS[0]) {
+    return;
   }
 
-  uint8_t data = _wire->read();
+  _busWindowCount++;
+  if (!ok) {
+    _busWindowErrors++;
+  }
 
-  // Validate PEC if enabled
-  if (_pecEnabled) {
-    uint8_t receivedPEC = _wire->read();
-    uint8_t packet[] = {(uint8_t)(_address << 1), reg, (uint8_t)((_address << 1) | 1), data};
-    if (!validatePEC(packet, 4, receivedPEC)) {
-      return 0; // Error already set by validatePEC
+  if (_busWindowErrors >= BUS_HEALTH_MAX_ERRORS) {
+    // Step down to the next slower rate
+    uint32_t slower = BUS_SPEED_STEPS[0];
+    for (uint8_t i = 0; i < BUS_SPEED_STEP_COUNT && BUS_SPEED_STEPS[i] < _busFrequency; i++) {
+      slower = BUS_SPEED_STEPS[i];
     }
+    BQ4050_DEBUG_PRINTF("Bus errors rising: %lu -> %lu Hz", (unsigned long)_busFrequency, (unsigned long)slower);
+    applyBusFrequency(slower);
+  } else if (_busWindowCount >= BUS_HEALTH_WINDOW) {
+    _busWindowCount = 0;
+    _busWindowErrors = 0;
   }
+}
+
+// Timing Calibration
+uint8_t TimingProfile::computeChecksum() const {
+  uint8_t sum = 0xA5 ^ version;
+  sum += (uint8_t)(responseDelayUs & 0xFF) + (uint8_t)(responseDelayUs >> 8);
+  sum += (uint8_t)(macDelayUs & 0xFF) + (uint8_t)(macDelayUs >> 8);
+  return sum;
+}
+
+bool TimingProfile::isValid() const {
+  return version == VERSION && checksum == computeChecksum();
+}
+
+void BQ4050::setCalibrateOnBegin(bool enable) {
+  _calibrateOnBegin = enable;
+}
+
+TimingProfile BQ4050::getTimingProfile() const {
+  TimingProfile profile;
+  profile.version = TimingProfile::VERSION;
+  profile.responseDelayUs = _responseDelayUs;
+  profile.macDelayUs = _macDelayUs;
+  profile.checksum = profile.computeChecksum();
+  return profile;
+}
 
+bool BQ4050::setTimingProfile(const TimingProfile& profile) {
+  if (!profile.isValid() || profile.responseDelayUs > MAX_RESPONSE_DELAY_US ||
+      profile.macDelayUs < MIN_MAC_DELAY_US || profile.macDelayUs > MAX_MAC_DELAY_US) {
+    BQ4050_DEBUG_PRINT("Timing profile rejected");
+    setError(BQ4050_ERROR_INVALID_PARAMETER);
+    return false;
+  }
+  _responseDelayUs = profile.responseDelayUs;
+  _macDelayUs = profile.macDelayUs;
   setError(BQ4050_ERROR_NONE);
-  return data;
+  return true;
 }
 
-uint16_t BQ4050::readRegister16(uint8_t reg) {
-  _wire->beginTransmission(_address);
-  _wire->write(reg);
+void BQ4050::resetTimingProfile() {
+  _responseDelayUs = I2C_RESPONSE_DELAY_US;
+  _macDelayUs = MAC_PROCESSING_DELAY_US;
+}
 
-  if (_wire->endTransmission(false) != 0) {
-    setError(BQ4050_ERROR_I2C_NACK);
-    return 0;
+bool BQ4050::calibrateTiming() {
+  BQ4050_BUS_SCOPE();
+  // The probes reuse the MAC result registers; an outstanding split-phase read is lost
+  endManufacturerAccess();
+
+  // Measure single attempts; retries would hide a settle time that is too short
+  RetryPolicy policy = _retryPolicy;
+  _retryPolicy.maxAttempts = 1;
+
+  uint16_t responseDelayUs = 0;
+  uint16_t macDelayUs = 0;
+  if (!calibrateResponseDelay(responseDelayUs)) {
+    BQ4050_DEBUG_PRINT("Response delay calibration failed");
+    _retryPolicy = policy;
+    return false;
   }
+  _responseDelayUs = responseDelayUs;
 
-  uint8_t bytesToRead = _pecEnabled ? 3 : 2; // +1 for PEC if enabled
-  if (_wire->requestFrom(_address, bytesToRead) != bytesToRead) {
-    setError(BQ4050_ERROR_I2C_TIMEOUT);
-    return 0;
+  if (!calibrateMACDelay(macDelayUs)) {
+    BQ4050_DEBUG_PRINT("MAC delay calibration failed");
+    _retryPolicy = policy;
+    return false;
   }
+  _macDelayUs = macDelayUs;
+  _retryPolicy = policy;
 
-  uint8_t lsb = _wire->read();
-  uint8_t msb = _wire->read();
+  BQ4050_DEBUG_PRINTF("Calibrated: response %u us, MAC %u us", _responseDelayUs, _macDelayUs);
+  setError(BQ4050_ERROR_NONE);
+  return true;
+}
 
-  // Validate PEC if enabled
-  if (_pecEnabled) {
-    uint8_t receivedPEC = _wire->read();
-    uint8_t packet[] = {(uint8_t)(_address << 1), reg, (uint8_t)((_address << 1) | 1), lsb, msb};
-    if (!validatePEC(packet, 5, receivedPEC)) {
-      return 0; // Error already set by validatePEC
+bool BQ4050::probeResponseDelay(uint16_t turnaroundUs, const uint8_t* reference, uint8_t length) {
+  uint8_t block[MAX_SBS_STRING_LENGTH];
+  _responseDelayUs = turnaroundUs;
+  uint8_t received = readBlock(BQ4050_CMD_MANUFACTURER_NAME, block, sizeof(block));
+  return _lastError == BQ4050_ERROR_NONE && received == length && memcmp(block, reference, length) == 0;
+}
+
+bool BQ4050::calibrateResponseDelay(uint16_t& result) {
+  static const uint16_t candidates[] = {0, 25, 50, 100, 150, 250, 500, 1000, 2000};
+  uint16_t previous = _responseDelayUs;
+
+  // Reference copy of ManufacturerName() (readable in every security mode),
+  // taken with a turnaround far above anything a gauge needs
+  uint8_t reference[MAX_SBS_STRING_LENGTH];
+  _responseDelayUs = MAX_RESPONSE_DELAY_US;
+  uint8_t length = readBlock(BQ4050_CMD_MANUFACTURER_NAME, reference, sizeof(reference));
+  if (_lastError != BQ4050_ERROR_NONE || length == 0) {
+    _responseDelayUs = previous;
+    return false;
+  }
+
+  for (uint8_t i = 0; i < sizeof(candidates) / sizeof(candidates[0]); i++) {
+    uint8_t passed = 0;
+    while (passed < CALIBRATION_TRIALS && probeResponseDelay(candidates[i], reference, length)) {
+      passed++;
+    }
+    if (passed == CALIBRATION_TRIALS) {
+      // 50% margin over the shortest turnaround that read back cleanly every time
+      uint32_t withMargin = candidates[i] + candidates[i] / 2;
+      result = (withMargin > MAX_RESPONSE_DELAY_US) ? MAX_RESPONSE_DELAY_US : withMargin;
+      _responseDelayUs = previous;
+      return true;
     }
   }
 
-  setError(BQ4050_ERROR_NONE);
-  return (msb << 8) | lsb;
+  _responseDelayUs = previous;
+  setError(BQ4050_ERROR_UNEXPECTED_RESPONSE);
+  return false;
 }
 
-uint32_t BQ4050::readRegister32(uint8_t reg) {
-  _wire->beginTransmission(_address);
-  _wire->write(reg);
+bool BQ4050::probeManufacturerAccess(uint16_t command, uint32_t waitUs) {
+  // ManufacturerBlockAccess() echoes the command once the result is ready; until
+  // then it still holds the previous command's response
+  BusLockScope busLock(this);
+  uint8_t request[] = {(uint8_t)(command & 0xFF), (uint8_t)((command >> 8) & 0xFF)};
+  if (!busLock.held() || !writeBlock(BQ4050_CMD_MANUFACTURER_BLOCK_ACCESS, request, sizeof(request))) {
+    return false;
+  }
+  sleepMicroseconds(waitUs);
+
+  uint8_t response[4];
+  uint8_t received = readBlock(BQ4050_CMD_MANUFACTURER_BLOCK_ACCESS, response, sizeof(response));
+  return _lastError == BQ4050_ERROR_NONE && received >= 2 &&
+         response[0] == request[0] && response[1] == request[1];
+}
+
+bool BQ4050::calibrateMACDelay(uint16_t& result) {
+  // Alternate two commands so a stale response can never match the expected echo
+  bool toggle = false;
+  uint32_t upper = _macDelayUs;
+  uint32_t lower = 0;
+
+  // Grow the upper bound until it passes every trial
+  for (;;) {
+    uint8_t passed = 0;
+    while (passed < CALIBRATION_TRIALS &&
+           probeManufacturerAccess((toggle = !toggle) ? BQ4050_MAC_DEVICE_TYPE : BQ4050_MAC_FIRMWARE_VERSION, upper)) {
+      passed++;
+    }
+    if (passed == CALIBRATION_TRIALS) {
+      break;
+    }
+    if (upper >= MAX_MAC_DELAY_US) {
+      setError(BQ4050_ERROR_UNEXPECTED_RESPONSE);
+      return false;
+    }
+    sleepMicroseconds(upper);  // Let the failed command finish before the next one
+    lower = upper;
+    upper = (upper * 2 > MAX_MAC_DELAY_US) ? MAX_MAC_DELAY_US : upper * 2;
+  }
 
-  if (_wire->endTransmission(false) != 0) {
-    setError(BQ4050_ERROR_I2C_NACK);
+  // Bisect down to 250 us resolution
+  while (upper - lower > 250) {
+    uint32_t middle = (lower + upper) / 2;
+    uint8_t passed = 0;
+    while (passed < CALIBRATION_TRIALS &&
+           probeManufacturerAccess((toggle = !toggle) ? BQ4050_MAC_DEVICE_TYPE : BQ4050_MAC_FIRMWARE_VERSION, middle)) {
+      passed++;
+    }
+    if (passed == CALIBRATION_TRIALS) {
+      upper = middle;
+    } else {
+      sleepMicroseconds(upper);
+      lower = middle;
+    }
+  }
+
+  // 25% margin, covering longer commands and temperature drift
+  uint32_t withMargin = upper + upper / 4;
+  if (withMargin < MIN_MAC_DELAY_US) {
+    withMargin = MIN_MAC_DELAY_US;
+  } else if (withMargin > MAX_MAC_DELAY_US) {
+    withMargin = MAX_MAC_DELAY_US;
+  }
+  result = (uint16_t)withMargin;
+  return true;
+}
+
+// Enhanced I2C helper methods
+uint8_t BQ4050::readTransaction(uint8_t command, uint8_t* buffer, uint8_t length, bool exact,
+                                uint16_t turnaroundUs) {
+  if (!isSealedSBSCommand(command) && !requireAccess(BQ4050_SECURITY_UNSEALED)) {
     return 0;
   }
 
-  uint8_t bytesToRead = _pecEnabled ? 5 : 4; // +1 for PEC if enabled
-  if (_wire->requestFrom(_address, bytesToRead) != bytesToRead) {
-    setError(BQ4050_ERROR_I2C_TIMEOUT);
+  BusLockScope busLock(this);
+  if (!busLock.held()) {
     return 0;
   }
 
-  uint8_t data[4];
-  uint32_t result = 0;
-  for (int i = 0; i < 4; i++) {
-    data[i] = _wire->read();
-    result |= ((uint32_t)data[i]) << (i * 8);
+  RetryState retry;
+  beginRetry(retry);
+  for (;;) {
+    uint8_t received = 0;
+#if defined(BQ4050_BUS_STATS) || defined(BQ4050_LATENCY_STATS)
+    uint32_t startUs = micros();
+#endif
+    uint8_t status = _transport->writeRead(_address, &command, 1, buffer, length, received, turnaroundUs);
+    _lastTransportStatus = status;
+    _transferCount++;
+    bool complete = (status == BQ4050_TRANSPORT_OK) && received > 0 && (!exact || received == length);
+#ifdef BQ4050_BUS_STATS
+    recordBusTransfer(1, received, micros() - startUs, complete);
+#endif
+#ifdef BQ4050_LATENCY_STATS
+    recordLatency(LATENCY_SBS, command, micros() - startUs);
+#endif
+    trackBusHealth(complete || status == BQ4050_TRANSPORT_DATA_NACK);
+    if (status == BQ4050_TRANSPORT_ERROR) {
+      _retryStats.arbitrationLost++;  // Wire reports lost arbitration as "other error"
+    }
+    if (complete) {
+      endRetry(retry);
+      return received;
+    }
+
+    // Short reads count as timeouts; the command byte was accepted, so repeating is safe
+    uint8_t reason = (status == BQ4050_TRANSPORT_OK) ? (uint8_t)RETRY_ON_TIMEOUT : retryReasonFor(status);
+    if (shouldRetry(retry, reason)) {
+      continue;
+    }
+
+    if (status == BQ4050_TRANSPORT_ADDRESS_NACK) {
+      // Gauge gone: the pack may be swapped before it answers again
+      invalidateIdentity();
+      invalidateSecurityMode();
+    }
+    if (status != BQ4050_TRANSPORT_OK && status != BQ4050_TRANSPORT_TIMEOUT) {
+      BQ4050_DEBUG_PRINTF("I2C transmission failed: %d", status);
+      setError(BQ4050_ERROR_I2C_NACK);
+    } else {
+      BQ4050_DEBUG_PRINTF("I2C request failed: wanted %d, got %d", length, received);
+      setError(BQ4050_ERROR_I2C_TIMEOUT);
+    }
+    return 0;
   }
+}
 
-  // Validate PEC if enabled
+bool BQ4050::writeTransaction(const uint8_t* data, uint8_t length) {
+  // PEC covers the address write byte and every byte after it; the gauge NACKs
+  // a frame whose PEC does not match and discards the command
+  uint8_t frame[2 + MAX_BLOCK_LENGTH + 1];
   if (_pecEnabled) {
-    uint8_t receivedPEC = _wire->read();
-    uint8_t packet[] = {(uint8_t)(_address << 1), reg, (uint8_t)((_address << 1) | 1), data[0], data[1], data[2], data[3]};
-    if (!validatePEC(packet, 7, receivedPEC)) {
-      return 0; // Error already set by validatePEC
+    if (length >= sizeof(frame)) {
+      setError(BQ4050_ERROR_INVALID_PARAMETER);
+      return false;
     }
+    uint8_t crc = _pecAddressCRC;
+    for (uint8_t i = 0; i < length; i++) {
+      frame[i] = data[i];
+      crc = crc8Update(crc, data[i]);
+    }
+    frame[length++] = crc;
+    data = frame;
+  }
+
+  BusLockScope busLock(this);
+  if (!busLock.held()) {
+    return false;
+  }
+  if (data[0] == 0x00 || data[0] == BQ4050_CMD_MANUFACTURER_BLOCK_ACCESS) {
+    waitForDataFlashProgram();
+  }
+
+  RetryState retry;
+  beginRetry(retry);
+  for (;;) {
+#if defined(BQ4050_BUS_STATS) || defined(BQ4050_LATENCY_STATS)
+    uint32_t startUs = micros();
+#endif
+    uint8_t status = _transport->write(_address, data, length);
+    _lastTransportStatus = status;
+    _transferCount++;
+#ifdef BQ4050_BUS_STATS
+    recordBusTransfer(length, 0, micros() - startUs, status == BQ4050_TRANSPORT_OK);
+#endif
+#ifdef BQ4050_LATENCY_STATS
+    recordLatency(LATENCY_SBS, data[0], micros() - startUs);
+#endif
+    trackBusHealth(status == BQ4050_TRANSPORT_OK || status == BQ4050_TRANSPORT_DATA_NACK);
+    if (status == BQ4050_TRANSPORT_ERROR) {
+      _retryStats.arbitrationLost++;
+    }
+    if (status == BQ4050_TRANSPORT_OK) {
+      endRetry(retry);
+      setError(BQ4050_ERROR_NONE);
+      return true;
+    }
+
+    // Only repeat writes that never reached the gauge (address NACK, lost
+    // arbitration), so toggle-type MAC commands (FET control, LED, ...) cannot run twice.
+    // With PEC a data NACK is safe too: the gauge only acts on a frame whose PEC checked out.
+    if ((status == BQ4050_TRANSPORT_ADDRESS_NACK && shouldRetry(retry, RETRY_ON_ADDRESS_NACK)) ||
+        (status == BQ4050_TRANSPORT_ERROR && shouldRetry(retry, RETRY_ON_BUS_ERROR)) ||
+        (status == BQ4050_TRANSPORT_DATA_NACK && _pecEnabled && shouldRetry(retry, RETRY_ON_PEC_ERROR))) {
+      continue;
+    }
+
+    BQ4050_DEBUG_PRINTF("I2C write failed: %d", status);
+    setError(BQ4050_ERROR_I2C_NACK);
+    return false;
   }
+}
 
+// Retry Policy
+void BQ4050::setRetryPolicy(const RetryPolicy& policy) {
+  _retryPolicy = policy;
+  if (_retryPolicy.maxAttempts == 0) {
+    _retryPolicy.maxAttempts = 1;
+  }
+}
+
+RetryPolicy BQ4050::getRetryPolicy() const {
+  return _retryPolicy;
+}
+
+void BQ4050::resetRetryPolicy() {
+  _retryPolicy.maxAttempts = 3;
+  _retryPolicy.retryOn = RETRY_ON_TRANSIENT;
+  _retryPolicy.baseBackoffUs = 100;
+  _retryPolicy.maxBackoffUs = 2000;
+  _retryPolicy.budgetUs = 20000;
+
+  // DeviceType()/FirmwareVersion() read back as these when the gauge answered
+  // before the MAC result was ready
+  static const uint16_t identitySentinels[] = {0xFFA5, 0xFFFF, 0x0000};
+  clearSentinelRules();
+  for (uint8_t i = 0; i < sizeof(identitySentinels) / sizeof(identitySentinels[0]); i++) {
+    addSentinelRule(true, BQ4050_MAC_DEVICE_TYPE, identitySentinels[i]);
+    addSentinelRule(true, BQ4050_MAC_FIRMWARE_VERSION, identitySentinels[i]);
+  }
+}
+
+bool BQ4050::addSentinelRule(bool mac, uint16_t code, uint16_t value) {
+  if (_sentinelRuleCount >= BQ4050_SENTINEL_RULES) {
+    setError(BQ4050_ERROR_INVALID_PARAMETER);
+    return false;
+  }
+  SentinelRule& rule = _sentinelRules[_sentinelRuleCount++];
+  rule.mac = mac;
+  rule.code = code;
+  rule.value = value;
+  return true;
+}
+
+void BQ4050::clearSentinelRules() {
+  _sentinelRuleCount = 0;
+}
+
+const RetryStats& BQ4050::getRetryStats() const {
+  return _retryStats;
+}
+
+void BQ4050::resetRetryStats() {
+  memset(&_retryStats, 0, sizeof(_retryStats));
+}
+
+void BQ4050::beginRetry(RetryState& state) {
+  state.attempt = 0;
+  state.startUs = micros();
+}
+
+bool BQ4050::shouldRetry(RetryState& state, uint8_t reason) {
+  if (!(_retryPolicy.retryOn & reason)) {
+    return false;
+  }
+
+  uint32_t backoff = (uint32_t)_retryPolicy.baseBackoffUs << (state.attempt < 16 ? state.attempt : 16);
+  if (backoff > _retryPolicy.maxBackoffUs) {
+    backoff = _retryPolicy.maxBackoffUs;
+  }
+  // xorshift32 jitter over the upper half of the backoff keeps masters sharing
+  // the bus from retrying in lockstep
+  _retrySeed ^= _retrySeed << 13;
+  _retrySeed ^= _retrySeed >> 17;
+  _retrySeed ^= _retrySeed << 5;
+  backoff = backoff / 2 + _retrySeed % (backoff / 2 + 1);
+
+  if (state.attempt + 1 >= _retryPolicy.maxAttempts ||
+      (uint32_t)(micros() - state.startUs) + backoff > _retryPolicy.budgetUs) {
+    _retryStats.exhausted++;
+    return false;
+  }
+
+  state.attempt++;
+  _retryStats.retries++;
+  BQ4050_DEBUG_PRINTF("Retry %d after %lu us (reason 0x%02X)", state.attempt, (unsigned long)backoff, reason);
+  sleepMicroseconds(backoff);
+  return true;
+}
+
+void BQ4050::endRetry(const RetryState& state) {
+  if (state.attempt > 0) {
+    _retryStats.recovered++;
+  }
+}
+
+bool BQ4050::matchesSentinel(bool mac, uint16_t code, uint16_t value) {
+  for (uint8_t i = 0; i < _sentinelRuleCount; i++) {
+    const SentinelRule& rule = _sentinelRules[i];
+    if (rule.mac == mac && rule.code == code && rule.value == value) {
+      _retryStats.sentinels++;
+      return true;
+    }
+  }
+  return false;
+}
+
+// Background Polling
+bool BQ4050::pollRegister(uint8_t reg, uint32_t periodMs, uint32_t maxAgeMs) {
+  if (reg >= SHADOW_WORD_REGISTERS || periodMs == 0) {
+    setError(BQ4050_ERROR_INVALID_PARAMETER);
+    return false;
+  }
+
+  ShadowRegister* entry = findShadow(reg);
+  if (!entry) {
+    if (_shadowCount >= BQ4050_SHADOW_REGISTERS) {
+      setError(BQ4050_ERROR_INVALID_PARAMETER);
+      return false;
+    }
+    _shadowIndex[reg] = _shadowCount;
+    entry = &_shadow[_shadowCount++];
+    entry->reg = reg;
+    entry->valid = false;
+    entry->value = 0;
+    entry->stampMs = 0;
+    entry->dueMs = millis();  // First refresh on the next tick()
+  }
+  entry->periodMs = periodMs;
+  entry->maxAgeMs = maxAgeMs ? maxAgeMs : periodMs * 2;
   setError(BQ4050_ERROR_NONE);
-  return result;
+  return true;
 }
 
-bool BQ4050::writeRegister8(uint8_t reg, uint8_t value) {
-  _wire->beginTransmission(_address);
-  _wire->write(reg);
-  _wire->write(value);
+bool BQ4050::unpollRegister(uint8_t reg) {
+  if (!findShadow(reg)) {
+    return false;
+  }
 
-  if (_wire->endTransmission() != 0) {
-    setError(BQ4050_ERROR_I2C_NACK);
+  // Move the last slot into the hole so the table stays dense
+  uint8_t slot = _shadowIndex[reg];
+  _shadowIndex[reg] = NO_SHADOW;
+  if (--_shadowCount != slot) {
+    _shadow[slot] = _shadow[_shadowCount];
+    _shadowIndex[_shadow[slot].reg] = slot;
+  }
+  return true;
+}
+
+void BQ4050::clearPolling() {
+  _shadowCount = 0;
+  memset(_shadowIndex, NO_SHADOW, sizeof(_shadowIndex));
+}
+
+uint8_t BQ4050::tick() {
+  BQ4050_BUS_SCOPE();
+  uint8_t refreshed = 0;
+  for (uint8_t i = 0; i < _shadowCount; i++) {
+    ShadowRegister& entry = _shadow[i];
+    uint32_t now = millis();
+    if ((int32_t)(now - entry.dueMs) < 0) {
+      continue;
+    }
+
+    // A failed read keeps the old value, which then ages out on its own
+    uint16_t value = fetchRegister16(entry.reg);
+    entry.dueMs = now + entry.periodMs;
+    if (_lastError == BQ4050_ERROR_NONE) {
+      storeShadow(entry, value);
+      refreshed++;
+    }
+  }
+  return refreshed;
+}
+
+uint32_t BQ4050::getNextPollDelay() const {
+  uint32_t now = millis();
+  uint32_t next = SHADOW_AGE_NEVER;
+  for (uint8_t i = 0; i < _shadowCount; i++) {
+    int32_t wait = (int32_t)(_shadow[i].dueMs - now);
+    if (wait <= 0) {
+      return 0;
+    }
+    if ((uint32_t)wait < next) {
+      next = wait;
+    }
+  }
+  return next;
+}
+
+bool BQ4050::readShadow(uint8_t reg, uint16_t& value, uint32_t maxAgeMs) {
+  BQ4050_BUS_SCOPE();
+  ShadowRegister* entry = findShadow(reg);
+  if (entry && entry->valid && millis() - entry->stampMs <= maxAgeMs) {
+    value = entry->value;
+    setError(BQ4050_ERROR_NONE);
+    return true;
+  }
+
+  uint16_t fresh = fetchRegister16(reg);
+  if (_lastError != BQ4050_ERROR_NONE) {
+    return false;
+  }
+  if (entry) {
+    storeShadow(*entry, fresh);
+  }
+  value = fresh;
+  return true;
+}
+
+uint32_t BQ4050::getShadowAge(uint8_t reg) const {
+  if (reg >= SHADOW_WORD_REGISTERS || _shadowIndex[reg] == NO_SHADOW) {
+    return SHADOW_AGE_NEVER;
+  }
+  const ShadowRegister& entry = _shadow[_shadowIndex[reg]];
+  return entry.valid ? millis() - entry.stampMs : SHADOW_AGE_NEVER;
+}
+
+void BQ4050::invalidateShadow() {
+  uint32_t now = millis();
+  for (uint8_t i = 0; i < _shadowCount; i++) {
+    _shadow[i].valid = false;
+    _shadow[i].dueMs = now;
+  }
+}
+
+BQ4050::ShadowRegister* BQ4050::findShadow(uint8_t reg) {
+  if (reg >= SHADOW_WORD_REGISTERS || _shadowIndex[reg] == NO_SHADOW) {
+    return nullptr;
+  }
+  return &_shadow[_shadowIndex[reg]];
+}
+
+void BQ4050::storeShadow(ShadowRegister& entry, uint16_t value) {
+  entry.value = value;
+  entry.stampMs = millis();
+  entry.valid = true;
+}
+
+void BQ4050::dropShadow(uint8_t reg) {
+  ShadowRegister* entry = findShadow(reg);
+  if (entry) {
+    // The written value is read back on the next tick() or getter call
+    entry->valid = false;
+    entry->dueMs = millis();
+  }
+}
+
+// Identity Cache
+void BQ4050::setIdentityCacheEnabled(bool enable) {
+  _identityCacheEnabled = enable;
+  if (!enable) {
+    invalidateIdentity();
+  }
+}
+
+void BQ4050::invalidateIdentity() {
+  _identity.fields = 0;
+  _identityOperationStatus = OPERATION_STATUS_UNKNOWN;
+}
+
+const IdentityInfo& BQ4050::getIdentity() const {
+  return _identity;
+}
+
+void BQ4050::fillIdentity() {
+  if (!_identityCacheEnabled) {
+    return;
+  }
+  // Each getter reads only when its field is missing
+  getDeviceType();
+  getFirmwareVersion();
+  getHardwareVersion();
+  getDesignCapacity();
+  getDesignVoltage();
+  getSerialNumber();
+  getManufacturerDate();
+  getManufacturerName();
+  getDeviceName();
+  getDeviceChemistry();
+  setError(BQ4050_ERROR_NONE);  // Fields that failed are read again on demand
+}
+
+bool BQ4050::refreshIdentity() {
+  BQ4050_BUS_SCOPE();
+  bool wasEnabled = _identityCacheEnabled;
+  _identityCacheEnabled = true;
+  invalidateIdentity();
+  fillIdentity();
+  _identityCacheEnabled = wasEnabled;
+
+  bool complete = (_identity.fields == IDENTITY_ALL);
+  setError(complete ? BQ4050_ERROR_NONE : BQ4050_ERROR_UNEXPECTED_RESPONSE);
+  return complete;
+}
+
+bool BQ4050::validateIdentity() {
+  BQ4050_BUS_SCOPE();
+  if (_identity.fields == 0) {
+    return false;
+  }
+
+  // OperationStatus first: observeOperationStatus() drops the cache on INIT/PRES changes
+  uint32_t operationStatus = 0;
+  readOperationStatus(operationStatus);
+  if (_identity.fields == 0) {
+    return false;
+  }
+
+  if (_identity.fields & IDENTITY_SERIAL_NUMBER) {
+    uint16_t serialNumber = fetchRegister16(BQ4050_CMD_SERIAL_NUMBER);
+    if (_lastError == BQ4050_ERROR_NONE && serialNumber != _identity.serialNumber) {
+      BQ4050_DEBUG_HEX("Serial number changed, identity dropped", serialNumber);
+      invalidateIdentity();
+      return false;
+    }
+  }
+  return _identity.fields != 0;
+}
+
+void BQ4050::observeOperationStatus(uint32_t operationStatus) {
+  // Seal/unseal changes what data flash is visible; drop the clean shadowed rows.
+  // Dirty ones stay, visible through hasUncommittedChanges(), for the caller to
+  // commit() or discard
+  BQ4050_SecurityMode mode = securityModeFromOperationStatus(operationStatus);
+  if (_lastSecurityMode != BQ4050_SECURITY_UNKNOWN && mode != _lastSecurityMode) {
+    invalidateDataFlashCache();
+  }
+  _lastSecurityMode = mode;
+
+  uint32_t marker = operationStatus & (OPERATION_STATUS_INIT | OPERATION_STATUS_PRES);
+  if (_identityOperationStatus != OPERATION_STATUS_UNKNOWN && marker != _identityOperationStatus) {
+    // Re-initialised gauge or pack removed/inserted
+    BQ4050_DEBUG_HEX("OperationStatus INIT/PRES changed, identity dropped", operationStatus);
+    invalidateIdentity();
+  }
+  _identityOperationStatus = marker;
+}
+
+// Shared-bus Lock
+void BQ4050::setBusLock(BQ4050BusLock* lock, uint32_t timeoutMs) {
+  // Never swap locks while one is held
+  if (_busLockDepth > 0) {
+    setError(BQ4050_ERROR_INVALID_PARAMETER);
+    return;
+  }
+  _busLock = lock;
+  _busLockTimeoutMs = timeoutMs;
+}
+
+BQ4050BusLock* BQ4050::getBusLock() const {
+  return _busLock;
+}
+
+bool BQ4050::acquireBusLock() {
+  if (_busLock == nullptr) {
+    return true;
+  }
+  if (_busLockDepth > 0) {
+    _busLockDepth++;
+    return true;
+  }
+  if (!_busLock->lock(_busLockTimeoutMs)) {
+    BQ4050_DEBUG_PRINT("Bus lock timeout");
+    setError(BQ4050_ERROR_I2C_TIMEOUT);
     return false;
   }
+  _busLockDepth = 1;
+  return true;
+}
+
+void BQ4050::releaseBusLock() {
+  if (_busLock == nullptr || _busLockDepth == 0) {
+    return;
+  }
+  if (--_busLockDepth == 0) {
+    _busLock->unlock();
+  }
+}
 
+// Stuck-bus Recovery
+bool BQ4050::recoverBus() {
+  BQ4050_BUS_SCOPE();
+  // Any split-phase MAC result is lost with the bus state
+  endManufacturerAccess();
+  if (!_transport->recoverBus()) {
+    BQ4050_DEBUG_PRINT("Bus recovery failed or unsupported by transport");
+    setError(BQ4050_ERROR_I2C_TIMEOUT);
+    return false;
+  }
   setError(BQ4050_ERROR_NONE);
   return true;
 }
 
+const BusRecoveryStats& BQ4050::getBusRecoveryStats() const {
+  return _transport->getRecoveryStats();
+}
+
+uint8_t BQ4050::retryReasonFor(uint8_t transportStatus) {
+  switch (transportStatus) {
+    case BQ4050_TRANSPORT_ADDRESS_NACK:
+      return RETRY_ON_ADDRESS_NACK;
+    case BQ4050_TRANSPORT_DATA_NACK:
+      return RETRY_ON_DATA_NACK;
+    case BQ4050_TRANSPORT_ERROR:
+      return RETRY_ON_BUS_ERROR;
+    case BQ4050_TRANSPORT_TIMEOUT:
+      return RETRY_ON_TIMEOUT;
+    default:
+      return 0;  // TOO_LONG never succeeds on a repeat
+  }
+}
+
+#ifdef BQ4050_BUS_STATS
+// Bus Accounting
+BQ4050::BusScope::BusScope(BQ4050* owner, const char* method) : _owner(owner) {
+  if (_owner->_busScopeDepth++ == 0) {
+    memset(&_owner->_busCall, 0, sizeof(_owner->_busCall));
+    _owner->_busCallName = method;
+  }
+}
+
+BQ4050::BusScope::~BusScope() {
+  if (--_owner->_busScopeDepth > 0) {
+    return;
+  }
+
+  BusStats& call = _owner->_busCall;
+  call.calls = 1;
+  _owner->_busTotals.calls++;
+  _owner->_busLastCall = call;
+  _owner->_busLastCallName = _owner->_busCallName;
+
+  // __func__ is a unique static string per function, so pointer equality identifies the method
+  BusMethodStats* entry = nullptr;
+  for (uint8_t i = 0; i < _owner->_busMethodCount; i++) {
+    if (_owner->_busMethods[i].method == _owner->_busCallName) {
+      entry = &_owner->_busMethods[i];
+      break;
+    }
+  }
+  if (entry == nullptr) {
+    if (_owner->_busMethodCount >= BQ4050_BUS_STATS_METHODS) {
+      return;  // Table full; still counted in the totals and last call
+    }
+    entry = &_owner->_busMethods[_owner->_busMethodCount++];
+    memset(entry, 0, sizeof(*entry));
+    entry->method = _owner->_busCallName;
+  }
+
+  entry->stats.calls++;
+  entry->stats.transactions += call.transactions;
+  entry->stats.bytesWritten += call.bytesWritten;
+  entry->stats.bytesRead += call.bytesRead;
+  entry->stats.wireTimeUs += call.wireTimeUs;
+  entry->stats.delayTimeUs += call.delayTimeUs;
+  entry->stats.errors += call.errors;
+}
+
+void BQ4050::recordBusTransfer(uint8_t written, uint8_t read, uint32_t wireUs, bool ok) {
+  BusStats* targets[] = {&_busTotals, _busScopeDepth > 0 ? &_busCall : nullptr};
+  for (BusStats* stats : targets) {
+    if (stats == nullptr) continue;
+    stats->transactions++;
+    stats->bytesWritten += written;
+    stats->bytesRead += read;
+    stats->wireTimeUs += wireUs;
+    if (!ok) stats->errors++;
+  }
+}
+
+void BQ4050::recordBusDelay(uint32_t delayUs) {
+  _busTotals.delayTimeUs += delayUs;
+  if (_busScopeDepth > 0) {
+    _busCall.delayTimeUs += delayUs;
+  }
+}
+
+const BusStats& BQ4050::getBusStats() const {
+  return _busTotals;
+}
+
+const BusStats& BQ4050::getLastCallStats() const {
+  return _busLastCall;
+}
+
+const char* BQ4050::getLastCallName() const {
+  return _busLastCallName;
+}
+
+uint8_t BQ4050::getMethodStatsCount() const {
+  return _busMethodCount;
+}
+
+BusMethodStats BQ4050::getMethodStats(uint8_t index) const {
+  if (index < _busMethodCount) {
+    return _busMethods[index];
+  }
+  BusMethodStats empty;
+  memset(&empty, 0, sizeof(empty));
+  return empty;
+}
+
+BusStats BQ4050::getMethodStats(const char* method) const {
+  for (uint8_t i = 0; i < _busMethodCount; i++) {
+    if (strcmp(_busMethods[i].method, method) == 0) {
+      return _busMethods[i].stats;
+    }
+  }
+  BusStats empty;
+  memset(&empty, 0, sizeof(empty));
+  return empty;
+}
+
+void BQ4050::resetBusStats() {
+  memset(&_busTotals, 0, sizeof(_busTotals));
+  memset(&_busCall, 0, sizeof(_busCall));
+  memset(&_busLastCall, 0, sizeof(_busLastCall));
+  _busCallName = "";
+  _busLastCallName = "";
+  _busMethodCount = 0;
+}
+#endif
+
+#ifdef BQ4050_LATENCY_STATS
+// Latency Histograms
+void LatencyHistogram::reset() {
+  count = 0;
+  minUs = 0;
+  maxUs = 0;
+  memset(buckets, 0, sizeof(buckets));
+}
+
+uint8_t LatencyHistogram::bucketFor(uint32_t microseconds) {
+  if (microseconds < 2) {
+    return 0;
+  }
+  // Octave = position of the top bit; the next bit picks the lower/upper half
+  uint8_t octave = 31 - __builtin_clz(microseconds);
+  uint8_t bucket = octave * 2 + ((microseconds >> (octave - 1)) & 1);
+  return (bucket < BUCKETS) ? bucket : BUCKETS - 1;
+}
+
+uint32_t LatencyHistogram::bucketUpperBound(uint8_t bucket) {
+  uint8_t octave = bucket / 2;
+  if (octave == 0) {
+    return 2;
+  }
+  uint32_t half = (uint32_t)1 << (octave - 1);
+  return ((uint32_t)1 << octave) + half * ((bucket & 1) + 1);
+}
+
+void LatencyHistogram::record(uint32_t microseconds) {
+  if (count == 0 || microseconds < minUs) minUs = microseconds;
+  if (microseconds > maxUs) maxUs = microseconds;
+  count++;
+
+  uint16_t& slot = buckets[bucketFor(microseconds)];
+  if (slot < 0xFFFF) {
+    slot++;
+  }
+}
+
+uint32_t LatencyHistogram::percentile(uint8_t percent) const {
+  if (count == 0) {
+    return 0;
+  }
+
+  uint32_t total = 0;
+  for (uint8_t i = 0; i < BUCKETS; i++) {
+    total += buckets[i];
+  }
+  uint32_t rank = (total * percent + 99) / 100;
+  if (rank == 0) {
+    return minUs;
+  }
+
+  uint32_t seen = 0;
+  for (uint8_t i = 0; i < BUCKETS; i++) {
+    seen += buckets[i];
+    if (seen >= rank) {
+      // The last bucket is open ended, so only maxUs bounds it
+      uint32_t bound = (i == BUCKETS - 1) ? maxUs : bucketUpperBound(i);
+      return (bound < maxUs) ? bound : maxUs;
+    }
+  }
+  return maxUs;
+}
+
+void BQ4050::recordLatency(BQ4050_LatencyKind kind, uint16_t code, uint32_t microseconds) {
+  for (uint8_t i = 0; i < _latencyCount; i++) {
+    if (_latency[i].kind == kind && _latency[i].code == code) {
+      _latency[i].record(microseconds);
+      return;
+    }
+  }
+
+  if (_latencyCount >= BQ4050_LATENCY_SLOTS) {
+    _latencyDropped++;
+    return;
+  }
+
+  LatencyHistogram& histogram = _latency[_latencyCount++];
+  histogram.reset();
+  histogram.kind = kind;
+  histogram.code = code;
+  histogram.record(microseconds);
+}
+
+const LatencyHistogram* BQ4050::getLatencyHistogram(BQ4050_LatencyKind kind, uint16_t code) const {
+  for (uint8_t i = 0; i < _latencyCount; i++) {
+    if (_latency[i].kind == kind && _latency[i].code == code) {
+      return &_latency[i];
+    }
+  }
+  return nullptr;
+}
+
+uint8_t BQ4050::getLatencyHistogramCount() const {
+  return _latencyCount;
+}
+
+const LatencyHistogram* BQ4050::getLatencyHistogramAt(uint8_t index) const {
+  return (index < _latencyCount) ? &_latency[index] : nullptr;
+}
+
+uint32_t BQ4050::getLatencyDroppedCount() const {
+  return _latencyDropped;
+}
+
+void BQ4050::resetLatencyHistograms() {
+  _latencyCount = 0;
+  _latencyDropped = 0;
+}
+
+void BQ4050::exportLatencyHistograms(Print& out) const {
+  out.println(F("kind,code,count,min_us,p50_us,p90_us,p99_us,max_us"));
+  for (uint8_t i = 0; i < _latencyCount; i++) {
+    const LatencyHistogram& histogram = _latency[i];
+    out.print(histogram.kind == LATENCY_MAC ? F("MAC") : F("SBS"));
+    out.print(F(",0x"));
+    out.print(histogram.code, HEX);
+    out.print(',');
+    out.print(histogram.count);
+    out.print(',');
+    out.print(histogram.minUs);
+    out.print(',');
+    out.print(histogram.percentile(50));
+    out.print(',');
+    out.print(histogram.percentile(90));
+    out.print(',');
+    out.print(histogram.percentile(99));
+    out.print(',');
+    out.println(histogram.maxUs);
+  }
+}
+#endif
+
+// Private I2C Communication Methods
+uint8_t BQ4050::readRegister8(uint8_t reg) {
+  RetryState retry;
+  beginRetry(retry);
+  for (;;) {
+    uint8_t response[2];
+    uint8_t bytesToRead = _pecEnabled ? 2 : 1; // +1 for PEC if enabled
+    if (readTransaction(reg, response, bytesToRead, true, _responseDelayUs) == 0) {
+      return 0;
+    }
+
+    uint8_t data = response[0];
+
+    // Validate PEC if enabled
+    if (_pecEnabled) {
+      if (!checkPEC(pecReadPrefix(reg), response, 1, response[1])) {
+        if (shouldRetry(retry, RETRY_ON_PEC_ERROR)) {
+          continue;
+        }
+        return 0; // Error already set by checkPEC
+      }
+    }
+
+    endRetry(retry);
+    setError(BQ4050_ERROR_NONE);
+    return data;
+  }
+}
+
+uint16_t BQ4050::readRegister16(uint8_t reg) {
+  ShadowRegister* entry = findShadow(reg);
+  if (entry && entry->valid && millis() - entry->stampMs <= entry->maxAgeMs) {
+    setError(BQ4050_ERROR_NONE);
+    return entry->value;
+  }
+
+  return refreshRegister16(reg);
+}
+
+uint16_t BQ4050::refreshRegister16(uint8_t reg) {
+  uint16_t value = fetchRegister16(reg);
+  ShadowRegister* entry = findShadow(reg);
+  if (entry && _lastError == BQ4050_ERROR_NONE) {
+    storeShadow(*entry, value);
+  }
+  return value;
+}
+
+uint16_t BQ4050::fetchRegister16(uint8_t reg) {
+  RetryState retry;
+  beginRetry(retry);
+  for (;;) {
+    uint8_t response[3];
+    uint8_t bytesToRead = _pecEnabled ? 3 : 2; // +1 for PEC if enabled
+    if (readTransaction(reg, response, bytesToRead, true) == 0) {
+      return 0;
+    }
+
+    uint8_t lsb = response[0];
+    uint8_t msb = response[1];
+
+    // Validate PEC if enabled
+    if (_pecEnabled) {
+      if (!checkPEC(pecReadPrefix(reg), response, 2, response[2])) {
+        if (shouldRetry(retry, RETRY_ON_PEC_ERROR)) {
+          continue;
+        }
+        return 0; // Error already set by checkPEC
+      }
+    }
+
+    uint16_t value = (msb << 8) | lsb;
+    if (matchesSentinel(false, reg, value)) {
+      if (shouldRetry(retry, RETRY_ON_SENTINEL)) {
+        continue;
+      }
+      setError(BQ4050_ERROR_UNEXPECTED_RESPONSE);
+      return value;
+    }
+
+    endRetry(retry);
+    setError(BQ4050_ERROR_NONE);
+    return value;
+  }
+}
+
+uint32_t BQ4050::readRegister32(uint8_t reg) {
+  RetryState retry;
+  beginRetry(retry);
+  for (;;) {
+    uint8_t response[5];
+    uint8_t bytesToRead = _pecEnabled ? 5 : 4; // +1 for PEC if enabled
+    if (readTransaction(reg, response, bytesToRead, true) == 0) {
+      return 0;
+    }
+
+    uint32_t result = 0;
+    for (int i = 0; i < 4; i++) {
+      result |= ((uint32_t)response[i]) << (i * 8);
+    }
+
+    // Validate PEC if enabled
+    if (_pecEnabled) {
+      if (!checkPEC(pecReadPrefix(reg), response, 4, response[4])) {
+        if (shouldRetry(retry, RETRY_ON_PEC_ERROR)) {
+          continue;
+        }
+        return 0; // Error already set by checkPEC
+      }
+    }
+
+    endRetry(retry);
+    setError(BQ4050_ERROR_NONE);
+    return result;
+  }
+}
+
+bool BQ4050::writeRegister8(uint8_t reg, uint8_t value) {
+  dropShadow(reg);
+  uint8_t packet[] = {reg, value};
+  return writeTransaction(packet, sizeof(packet));
+}
+
 bool BQ4050::writeRegister16(uint8_t reg, uint16_t value) {
-  _wire->beginTransmission(_address);
-  _wire->write(reg);
-  _wire->write(value & 0xFF);        // LSB
-  _wire->write((value >> 8) & 0xFF); // MSB
+  dropShadow(reg);
+  uint8_t packet[] = {reg, (uint8_t)(value & 0xFF), (uint8_t)((value >> 8) & 0xFF)}; // LSB, MSB
+  return writeTransaction(packet, sizeof(packet));
+}
 
-  if (_wire->endTransmission() != 0) {
-    setError(BQ4050_ERROR_I2C_NACK);
+bool BQ4050::writeBlock(uint8_t command, const uint8_t* data, uint8_t length) {
+  if (length > MAX_BLOCK_LENGTH) {
+    setError(BQ4050_ERROR_INVALID_PARAMETER);
     return false;
   }
 
-  setError(BQ4050_ERROR_NONE);
+  uint8_t packet[2 + MAX_BLOCK_LENGTH];
+  packet[0] = command;
+  packet[1] = length;  // SMBus block byte count
+  memcpy(packet + 2, data, length);
+  return writeTransaction(packet, length + 2);
+}
+
+// Manufacturer Access Methods
+uint16_t BQ4050::manufacturerAccess16(uint16_t command) {
+  RetryState retry;
+  beginRetry(retry);
+  for (;;) {
+    if (!startManufacturerAccess(command)) {
+      return 0;
+    }
+    uint16_t result = completeManufacturerAccess16();
+    if (_lastError != BQ4050_ERROR_NONE || !matchesSentinel(true, command, result)) {
+      if (_lastError == BQ4050_ERROR_NONE) {
+        endRetry(retry);
+      }
+      return result;
+    }
+    // Re-issue the command; the gauge answered with a placeholder value
+    if (!shouldRetry(retry, RETRY_ON_SENTINEL)) {
+      setError(BQ4050_ERROR_UNEXPECTED_RESPONSE);
+      return result;
+    }
+  }
+}
+
+uint32_t BQ4050::manufacturerAccess32(uint16_t command) {
+  if (!startManufacturerAccess(command)) {
+    return 0;
+  }
+  return completeManufacturerAccess32();
+}
+
+bool BQ4050::manufacturerAccessWrite(uint16_t command, uint16_t data) {
+  uint8_t packet[] = {
+    0x00,
+    (uint8_t)(command & 0xFF), (uint8_t)((command >> 8) & 0xFF),
+    (uint8_t)(data & 0xFF), (uint8_t)((data >> 8) & 0xFF)
+  };
+  return writeTransaction(packet, sizeof(packet));
+}
+
+uint8_t BQ4050::readMACBlock(uint16_t command, uint8_t* buffer, uint8_t length) {
+  // ManufacturerBlockAccess(): block write of the subcommand, then a block read
+  // returning the subcommand echo followed by the result
+  if (!isSealedMACCommand(command) && !requireAccess(BQ4050_SECURITY_UNSEALED)) {
+    return 0;
+  }
+  BusLockScope busLock(this);
+  if (!busLock.held()) {
+    return 0;
+  }
+
+  uint8_t request[2] = {(uint8_t)(command & 0xFF), (uint8_t)((command >> 8) & 0xFF)};
+  RetryState retry;
+  beginRetry(retry);
+  for (;;) {
+    if (!writeBlock(BQ4050_CMD_MANUFACTURER_BLOCK_ACCESS, request, sizeof(request))) {
+      return 0;
+    }
+    markManufacturerAccessPending(command);
+    waitForManufacturerAccess();
+    endManufacturerAccess();
+
+    uint8_t block[MAX_BLOCK_LENGTH];
+    uint8_t received = readBlock(BQ4050_CMD_MANUFACTURER_BLOCK_ACCESS, block, sizeof(block));
+    if (_lastError != BQ4050_ERROR_NONE) {
+      return 0;
+    }
+#ifdef BQ4050_LATENCY_STATS
+    recordLatency(LATENCY_MAC, command, micros() - _macStartUs);
+#endif
+
+    if (received < 2 || block[0] != request[0] || block[1] != request[1]) {
+      // Another master issued its own MAC command between our write and read
+      BQ4050_DEBUG_PRINTF("MAC 0x%04X echo mismatch", command);
+      _retryStats.arbitrationLost++;
+      if (shouldRetry(retry, RETRY_ON_BUS_ERROR)) {
+        continue;
+      }
+      setError(BQ4050_ERROR_UNEXPECTED_RESPONSE);
+      return 0;
+    }
+
+    endRetry(retry);
+    uint8_t count = received - 2;
+    if (count > length) {
+      count = length;
+    }
+    memcpy(buffer, block + 2, count);
+    return count;
+  }
+}
+
+void BQ4050::endManufacturerAccess() {
+  _macState = BQ4050_MAC_STATE_IDLE;
+  if (_macLockHeld) {
+    _macLockHeld = false;
+    releaseBusLock();
+  }
+}
+
+void BQ4050::markManufacturerAccessPending(uint16_t command) {
+  _macCommand = command;
+  _macStartUs = micros();
+  _macState = BQ4050_MAC_STATE_PENDING;
+}
+
+void BQ4050::waitForManufacturerAccess() {
+  while (pollManufacturerAccess() == BQ4050_MAC_STATE_PENDING) {
+    uint32_t elapsed = micros() - _macStartUs;
+    sleepMicroseconds((elapsed < _macDelayUs) ? _macDelayUs - elapsed : 0);
+  }
+}
+
+void BQ4050::sleepMicroseconds(uint32_t microseconds) {
+  // Sleep through whole milliseconds so RTOS tasks can run, spin only the tail
+#ifdef BQ4050_BUS_STATS
+  uint32_t delayStartUs = micros();
+#endif
+  if (microseconds >= 1000) {
+    delay(microseconds / 1000);
+  } else if (microseconds > 0) {
+    delayMicroseconds(microseconds);
+  }
+#ifdef BQ4050_BUS_STATS
+  recordBusDelay(micros() - delayStartUs);
+#endif
+}
+
+// Non-blocking Manufacturer Access
+bool BQ4050::startManufacturerAccess(uint16_t command) {
+  BQ4050_BUS_SCOPE();
+  if (!isSealedMACCommand(command) && !requireAccess(BQ4050_SECURITY_UNSEALED)) {
+    _macState = BQ4050_MAC_STATE_ERROR;
+    return false;
+  }
+  // Keep other masters' drivers off the bus until the result has been read,
+  // or they could overwrite ManufacturerAccess() in between
+  if (!_macLockHeld) {
+    if (!acquireBusLock()) {
+      _macState = BQ4050_MAC_STATE_ERROR;
+      return false;
+    }
+    _macLockHeld = true;
+  }
+  if (!writeRegister16(0x00, command)) {
+    endManufacturerAccess();
+    _macState = BQ4050_MAC_STATE_ERROR;
+    return false;
+  }
+  markManufacturerAccessPending(command);
   return true;
 }
 
-// Manufacturer Access Methods
-uint16_t BQ4050::manufacturerAccess16(uint16_t command) {
-  if (!writeRegister16(0x00, command)) {
-    return 0;
+BQ4050_MACState BQ4050::pollManufacturerAccess() {
+  if (_macState == BQ4050_MAC_STATE_PENDING &&
+      (uint32_t)(micros() - _macStartUs) >= _macDelayUs) {
+    _macState = BQ4050_MAC_STATE_READY;
+  }
+  return _macState;
+}
+
+bool BQ4050::isManufacturerAccessReady() {
+  return pollManufacturerAccess() == BQ4050_MAC_STATE_READY;
+}
+
+uint16_t BQ4050::getPendingManufacturerAccess() const {
+  return _macCommand;
+}
+
+uint16_t BQ4050::completeManufacturerAccess16() {
+  BQ4050_BUS_SCOPE();
+  if (_macState != BQ4050_MAC_STATE_PENDING && _macState != BQ4050_MAC_STATE_READY) {
+    setError(BQ4050_ERROR_INVALID_PARAMETER);
+    return 0;
+  }
+  waitForManufacturerAccess();
+  _macState = BQ4050_MAC_STATE_IDLE;
+  uint16_t result = fetchRegister16(0x00);
+  endManufacturerAccess();
+#ifdef BQ4050_LATENCY_STATS
+  recordLatency(LATENCY_MAC, _macCommand, micros() - _macStartUs);
+#endif
+  return result;
+}
+
+uint32_t BQ4050::completeManufacturerAccess32() {
+  BQ4050_BUS_SCOPE();
+  if (_macState != BQ4050_MAC_STATE_PENDING && _macState != BQ4050_MAC_STATE_READY) {
+    setError(BQ4050_ERROR_INVALID_PARAMETER);
+    return 0;
+  }
+  waitForManufacturerAccess();
+  _macState = BQ4050_MAC_STATE_IDLE;
+  uint32_t result = readRegister32(0x00);
+  endManufacturerAccess();
+#ifdef BQ4050_LATENCY_STATS
+  recordLatency(LATENCY_MAC, _macCommand, micros() - _macStartUs);
+#endif
+  return result;
+}
+
+String BQ4050::completeManufacturerAccessBlock() {
+  BQ4050_BUS_SCOPE();
+  if (_macState != BQ4050_MAC_STATE_PENDING && _macState != BQ4050_MAC_STATE_READY) {
+    setError(BQ4050_ERROR_INVALID_PARAMETER);
+    return "";
+  }
+  waitForManufacturerAccess();
+  _macState = BQ4050_MAC_STATE_IDLE;
+  // Read the full data block from ManufacturerData (0x23)
+  String result = readSBSString(BQ4050_CMD_MANUFACTURER_DATA);
+  endManufacturerAccess();
+#ifdef BQ4050_LATENCY_STATS
+  recordLatency(LATENCY_MAC, _macCommand, micros() - _macStartUs);
+#endif
+  return result;
+}
+
+void BQ4050::cancelManufacturerAccess() {
+  endManufacturerAccess();
+}
+
+// Pipelined transactions
+bool BQ4050::runSchedule(TransactionSchedule& schedule) {
+  BQ4050_BUS_SCOPE();
+  bool success = true;
+  uint8_t nextRead = 0;
+  uint8_t nextBlock = 0;
+
+  for (uint8_t i = 0; i < schedule.macCount; i++) {
+    TransactionSchedule::MACRead& mac = schedule.macReads[i];
+
+    if (!startManufacturerAccess(mac.command)) {
+      mac.ok = false;
+      success = false;
+      continue;
+    }
+
+    // Fill the gauge's processing window with queued SBS reads
+    while (pollManufacturerAccess() == BQ4050_MAC_STATE_PENDING &&
+           runNextScheduledRead(schedule, nextRead, nextBlock, success)) {
+    }
+
+    mac.value = mac.wide ? completeManufacturerAccess32() : completeManufacturerAccess16();
+    mac.ok = (_lastError == BQ4050_ERROR_NONE);
+    success &= mac.ok;
+  }
+
+  // Whatever did not fit into a MAC window runs back-to-back
+  while (runNextScheduledRead(schedule, nextRead, nextBlock, success)) {
   }
-  delay(5); // Allow processing time
-  return readRegister16(0x00);
+
+  BQ4050_DEBUG_PRINTF("Schedule: %d MAC, %d SBS, %d block, %s", schedule.macCount, schedule.readCount,
+                      schedule.blockCount, success ? "ok" : "errors");
+  return success;
 }
 
-uint32_t BQ4050::manufacturerAccess32(uint16_t command) {
-  if (!writeRegister16(0x00, command)) {
-    return 0;
+bool BQ4050::runNextScheduledRead(TransactionSchedule& schedule, uint8_t& nextRead, uint8_t& nextBlock,
+                                  bool& success) {
+  if (nextRead < schedule.readCount) {
+    TransactionSchedule::Read& read = schedule.reads[nextRead++];
+    read.value = refreshRegister16(read.reg);  // Scheduled reads are fresh by definition
+    read.ok = (_lastError == BQ4050_ERROR_NONE);
+    success &= read.ok;
+    return true;
   }
-  delay(5); // Allow processing time
-  return readRegister32(0x00);
-}
 
-bool BQ4050::manufacturerAccessWrite(uint16_t command, uint16_t data) {
-  _wire->beginTransmission(_address);
-  _wire->write(0x00);
-  _wire->write(command & 0xFF);
-  _wire->write((command >> 8) & 0xFF);
-  _wire->write(data & 0xFF);
-  _wire->write((data >> 8) & 0xFF);
-
-  if (_wire->endTransmission() != 0) {
-    setError(BQ4050_ERROR_I2C_NACK);
-    return false;
+  if (nextBlock < schedule.blockCount) {
+    TransactionSchedule::BlockRead& block = schedule.blockReads[nextBlock++];
+    uint8_t data[4];
+    uint8_t length = readBlock(block.reg, data, sizeof(data));
+
+    block.value = 0;
+    block.length = length;
+    for (uint8_t i = 0; i < length; i++) {
+      block.value |= (uint32_t)data[i] << (8 * i);
+    }
+    block.ok = (_lastError == BQ4050_ERROR_NONE && length > 0);
+    success &= block.ok;
+    return true;
   }
 
-  setError(BQ4050_ERROR_NONE);
-  return true;
+  return false;
 }
 
 // Smart PEC Management
@@ -248,6 +1693,21 @@ bool BQ4050::shouldUsePECForRegister(uint8_t reg) const {
   return _pecEnabled;  // Use global PEC setting for standard SBS registers
 }
 
+// Serve an identity field from the cache, or read it and remember it
+#define IDENTITY_CACHED(bit, field, readCall) \
+  do { \
+    if (_identityCacheEnabled && (_identity.fields & (bit))) { \
+      setError(BQ4050_ERROR_NONE); \
+      return _identity.field; \
+    } \
+    auto result = readCall; \
+    if (_identityCacheEnabled && _lastError == BQ4050_ERROR_NONE) { \
+      _identity.field = result; \
+      _identity.fields |= (bit); \
+    } \
+    return result; \
+  } while (0)
+
 // Helper macro to reduce duplication in smart PEC functions
 #define SMART_PEC_READ(reg, readCall) \
   do { \
@@ -262,7 +1722,7 @@ bool BQ4050::shouldUsePECForRegister(uint8_t reg) const {
   } while(0)
 
 uint16_t BQ4050::readRegister16WithSmartPEC(uint8_t reg) {
-  SMART_PEC_READ(reg, readRegister16(reg));
+  SMART_PEC_READ(reg, refreshRegister16(reg));
 }
 
 uint32_t BQ4050::readRegister32WithSmartPEC(uint8_t reg) {
@@ -291,105 +1751,127 @@ float BQ4050::convertCurrent(int16_t rawCurrent) {
 
 // Basic SBS Commands Implementation
 uint16_t BQ4050::getRemainingCapacityAlarm() {
+  BQ4050_BUS_SCOPE();
   return readRegister16(BQ4050_CMD_REMAINING_CAPACITY_ALARM);
 }
 
 uint16_t BQ4050::getRemainingTimeAlarm() {
+  BQ4050_BUS_SCOPE();
   return readRegister16(BQ4050_CMD_REMAINING_TIME_ALARM);
 }
 
 uint16_t BQ4050::getBatteryMode() {
+  BQ4050_BUS_SCOPE();
   return readRegister16(BQ4050_CMD_BATTERY_MODE);
 }
 
 bool BQ4050::setBatteryMode(uint16_t mode) {
+  BQ4050_BUS_SCOPE();
   return writeRegister16(BQ4050_CMD_BATTERY_MODE, mode);
 }
 
 float BQ4050::getTemperature() {
+  BQ4050_BUS_SCOPE();
   uint16_t rawTemp = readRegister16(BQ4050_CMD_TEMPERATURE);
   if (_lastError != BQ4050_ERROR_NONE) return 0.0;
   return convertTemperature(rawTemp);
 }
 
 float BQ4050::getVoltage() {
+  BQ4050_BUS_SCOPE();
   uint16_t rawVoltage = readRegister16(BQ4050_CMD_VOLTAGE);
   if (_lastError != BQ4050_ERROR_NONE) return 0.0;
   return convertVoltage(rawVoltage);
 }
 
 float BQ4050::getCurrent() {
+  BQ4050_BUS_SCOPE();
   int16_t rawCurrent = (int16_t)readRegister16(BQ4050_CMD_CURRENT);
   if (_lastError != BQ4050_ERROR_NONE) return 0.0;
   return convertCurrent(rawCurrent);
 }
 
 float BQ4050::getAverageCurrent() {
+  BQ4050_BUS_SCOPE();
   int16_t rawCurrent = (int16_t)readRegister16(BQ4050_CMD_AVERAGE_CURRENT);
   if (_lastError != BQ4050_ERROR_NONE) return 0.0;
   return convertCurrent(rawCurrent);
 }
 
 uint8_t BQ4050::getRelativeStateOfCharge() {
+  BQ4050_BUS_SCOPE();
   return readRegister16(BQ4050_CMD_RELATIVE_STATE_OF_CHARGE) & 0xFF;
 }
 
 uint8_t BQ4050::getAbsoluteStateOfCharge() {
+  BQ4050_BUS_SCOPE();
   return readRegister16(BQ4050_CMD_ABSOLUTE_STATE_OF_CHARGE) & 0xFF;
 }
 
 uint16_t BQ4050::getRemainingCapacity() {
+  BQ4050_BUS_SCOPE();
   return readRegister16(BQ4050_CMD_REMAINING_CAPACITY);
 }
 
 uint16_t BQ4050::getFullChargeCapacity() {
+  BQ4050_BUS_SCOPE();
   return readRegister16(BQ4050_CMD_FULL_CHARGE_CAPACITY);
 }
 
 uint16_t BQ4050::getBatteryStatus() {
+  BQ4050_BUS_SCOPE();
   return readRegister16(BQ4050_CMD_BATTERY_STATUS);
 }
 
 uint16_t BQ4050::getCycleCount() {
+  BQ4050_BUS_SCOPE();
   return readRegister16(BQ4050_CMD_CYCLE_COUNT);
 }
 
 uint16_t BQ4050::getDesignCapacity() {
-  return readRegister16(BQ4050_CMD_DESIGN_CAPACITY);
+  BQ4050_BUS_SCOPE();
+  IDENTITY_CACHED(IDENTITY_DESIGN_CAPACITY, designCapacity, readRegister16(BQ4050_CMD_DESIGN_CAPACITY));
 }
 
 uint16_t BQ4050::getDesignVoltage() {
-  return readRegister16(BQ4050_CMD_DESIGN_VOLTAGE);
+  BQ4050_BUS_SCOPE();
+  IDENTITY_CACHED(IDENTITY_DESIGN_VOLTAGE, designVoltage, readRegister16(BQ4050_CMD_DESIGN_VOLTAGE));
 }
 
 uint16_t BQ4050::getManufacturerDate() {
-  return readRegister16(BQ4050_CMD_MANUFACTURER_DATE);
+  BQ4050_BUS_SCOPE();
+  IDENTITY_CACHED(IDENTITY_MANUFACTURER_DATE, manufacturerDate, readRegister16(BQ4050_CMD_MANUFACTURER_DATE));
 }
 
 uint16_t BQ4050::getSerialNumber() {
-  return readRegister16(BQ4050_CMD_SERIAL_NUMBER);
+  BQ4050_BUS_SCOPE();
+  IDENTITY_CACHED(IDENTITY_SERIAL_NUMBER, serialNumber, readRegister16(BQ4050_CMD_SERIAL_NUMBER));
 }
 
 // Cell Voltages
 float BQ4050::getCellVoltage1() {
+  BQ4050_BUS_SCOPE();
   uint16_t rawVoltage = readRegister16(BQ4050_CMD_CELL_VOLTAGE_1);
   if (_lastError != BQ4050_ERROR_NONE) return 0.0;
   return convertVoltage(rawVoltage);
 }
 
 float BQ4050::getCellVoltage2() {
+  BQ4050_BUS_SCOPE();
   uint16_t rawVoltage = readRegister16(BQ4050_CMD_CELL_VOLTAGE_2);
   if (_lastError != BQ4050_ERROR_NONE) return 0.0;
   return convertVoltage(rawVoltage);
 }
 
 float BQ4050::getCellVoltage3() {
+  BQ4050_BUS_SCOPE();
   uint16_t rawVoltage = readRegister16(BQ4050_CMD_CELL_VOLTAGE_3);
   if (_lastError != BQ4050_ERROR_NONE) return 0.0;
   return convertVoltage(rawVoltage);
 }
 
 float BQ4050::getCellVoltage4() {
+  BQ4050_BUS_SCOPE();
   uint16_t rawVoltage = readRegister16(BQ4050_CMD_CELL_VOLTAGE_4);
   if (_lastError != BQ4050_ERROR_NONE) return 0.0;
   return convertVoltage(rawVoltage);
@@ -397,120 +1879,278 @@ float BQ4050::getCellVoltage4() {
 
 // Status and Alerts
 uint16_t BQ4050::getSafetyAlert() {
-  return readRegister16WithSmartPEC(BQ4050_CMD_SAFETY_ALERT);
+  BQ4050_BUS_SCOPE();
+  return readStatusRegister16(BQ4050_CMD_SAFETY_ALERT);
 }
 
 uint16_t BQ4050::getSafetyStatus() {
-  return readRegister16WithSmartPEC(BQ4050_CMD_SAFETY_STATUS);
+  BQ4050_BUS_SCOPE();
+  return readStatusRegister16(BQ4050_CMD_SAFETY_STATUS);
 }
 
 uint16_t BQ4050::getPFAlert() {
-  return readRegister16WithSmartPEC(BQ4050_CMD_PF_ALERT);
+  BQ4050_BUS_SCOPE();
+  return readStatusRegister16(BQ4050_CMD_PF_ALERT);
 }
 
 uint16_t BQ4050::getPFStatus() {
-  return readRegister16WithSmartPEC(BQ4050_CMD_PF_STATUS);
+  BQ4050_BUS_SCOPE();
+  return readStatusRegister16(BQ4050_CMD_PF_STATUS);
 }
 
 uint16_t BQ4050::getOperationStatus() {
-  return readRegister16WithSmartPEC(BQ4050_CMD_OPERATION_STATUS);
+  BQ4050_BUS_SCOPE();
+  return readStatusRegister16(BQ4050_CMD_OPERATION_STATUS);
 }
 
 uint16_t BQ4050::getChargingStatus() {
-  return readRegister16WithSmartPEC(BQ4050_CMD_CHARGING_STATUS);
+  BQ4050_BUS_SCOPE();
+  return readStatusRegister16(BQ4050_CMD_CHARGING_STATUS);
 }
 
 uint16_t BQ4050::getGaugingStatus() {
-  return readRegister16WithSmartPEC(BQ4050_CMD_GAUGING_STATUS);
+  BQ4050_BUS_SCOPE();
+  return readStatusRegister16(BQ4050_CMD_GAUGING_STATUS);
+}
+
+StatusSnapshot BQ4050::getStatusSnapshot() {
+  BQ4050_BUS_SCOPE();
+  StatusSnapshot snapshot;
+  memset(&snapshot, 0, sizeof(snapshot));
+
+  // 0x50-0x57 are H4 blocks; the word getters above only see the low half
+  uint32_t* targets[] = {
+    &snapshot.safetyAlert, &snapshot.safetyStatus, &snapshot.pfAlert, &snapshot.pfStatus,
+    &snapshot.operationStatus, &snapshot.chargingStatus, &snapshot.gaugingStatus,
+    &snapshot.manufacturingStatus
+  };
+
+  bool success = true;
+  bool operationStatusOk = false;
+  if (getSecurityMode() == BQ4050_SECURITY_SEALED) {
+    // Sealed: only the MAC mirrors 0x0050-0x0057 answer. The gauge holds one MAC
+    // result at a time and there is no SBS work left to fill the waits, so these
+    // run one after another, a MAC delay each
+    for (uint8_t i = 0; i < 8; i++) {
+      uint8_t data[4] = {0};
+      uint8_t received = readMACBlock(BQ4050_MAC_SAFETY_ALERT + i, data, sizeof(data));
+      *targets[i] = (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) |
+                    ((uint32_t)data[3] << 24);
+      bool ok = (_lastError == BQ4050_ERROR_NONE && received == sizeof(data));
+      success &= ok;
+      if (i == 4) {
+        operationStatusOk = ok;
+      }
+    }
+  } else {
+    TransactionSchedule schedule;
+    for (uint8_t i = 0; i < 8; i++) {
+      schedule.addBlockRead(BQ4050_CMD_SAFETY_ALERT + i);
+    }
+
+    success = runSchedule(schedule);
+    for (uint8_t i = 0; i < 8; i++) {
+      *targets[i] = schedule.blockReads[i].value;
+    }
+    operationStatusOk = schedule.blockReads[4].ok;
+  }
+  if (operationStatusOk) {
+    observeOperationStatus(snapshot.operationStatus);
+  }
+
+  // A later successful read clears _lastError, so keep the failure visible
+  if (!success && _lastError == BQ4050_ERROR_NONE) {
+    setError(BQ4050_ERROR_UNEXPECTED_RESPONSE);
+  }
+
+  return snapshot;
 }
 
 uint16_t BQ4050::getManufacturingStatus() {
-  return readRegister16WithSmartPEC(BQ4050_CMD_MANUFACTURING_STATUS);
+  BQ4050_BUS_SCOPE();
+  return readStatusRegister16(BQ4050_CMD_MANUFACTURING_STATUS);
 }
 
 // Extended SBS Commands
 uint16_t BQ4050::getAFERegister() {
+  BQ4050_BUS_SCOPE();
   return readRegister16WithSmartPEC(BQ4050_CMD_AFE_REGISTER);
 }
 
 uint32_t BQ4050::getLifeTimeDataBlock1() {
+  BQ4050_BUS_SCOPE();
   return readRegister32WithSmartPEC(BQ4050_CMD_LIFETIME_DATA_BLOCK_1);
 }
 
 uint32_t BQ4050::getLifeTimeDataBlock2() {
+  BQ4050_BUS_SCOPE();
   return readRegister32WithSmartPEC(BQ4050_CMD_LIFETIME_DATA_BLOCK_2);
 }
 
 uint32_t BQ4050::getLifeTimeDataBlock3() {
+  BQ4050_BUS_SCOPE();
   return readRegister32WithSmartPEC(BQ4050_CMD_LIFETIME_DATA_BLOCK_3);
 }
 
 uint32_t BQ4050::getLifeTimeDataBlock4() {
+  BQ4050_BUS_SCOPE();
   return readRegister32WithSmartPEC(BQ4050_CMD_LIFETIME_DATA_BLOCK_4);
 }
 
 uint32_t BQ4050::getLifeTimeDataBlock5() {
+  BQ4050_BUS_SCOPE();
   return readRegister32WithSmartPEC(BQ4050_CMD_LIFETIME_DATA_BLOCK_5);
 }
 
 String BQ4050::getManufacturerInfo() {
+  BQ4050_BUS_SCOPE();
   return readSBSStringWithSmartPEC(BQ4050_CMD_MANUFACTURER_INFO);
 }
 
 String BQ4050::getDAStatus1() {
+  BQ4050_BUS_SCOPE();
   return readSBSStringWithSmartPEC(BQ4050_CMD_DA_STATUS_1);
 }
 
+DAStatus1 BQ4050::getDAStatus1Data() {
+  BQ4050_BUS_SCOPE();
+  uint8_t data[MAX_BLOCK_LENGTH];
+  uint8_t length = readMirroredBlock(BQ4050_CMD_DA_STATUS_1, data, sizeof(data));
+
+  if (_lastError != BQ4050_ERROR_NONE) {
+    length = 0;
+  } else if (length < 12) {
+    // Not even the voltages arrived
+    setError(BQ4050_ERROR_UNEXPECTED_RESPONSE);
+    length = 0;
+  }
+
+  return decodeDAStatus1(data, length);
+}
+
+DAStatus1 BQ4050::decodeDAStatus1(const uint8_t* data, uint8_t length) {
+  DAStatus1 status;
+  memset(&status, 0, sizeof(status));
+  status.length = length;
+
+  // 16 little-endian words; anything past a truncated payload stays 0
+  int16_t words[16] = {0};
+  for (uint8_t i = 0; i < 16 && (i * 2 + 1) < length; i++) {
+    words[i] = (int16_t)(data[i * 2] | (data[i * 2 + 1] << 8));
+  }
+
+  for (uint8_t cell = 0; cell < 4; cell++) {
+    status.cellVoltage[cell] = convertVoltage((uint16_t)words[cell]);
+    status.cellCurrent[cell] = convertCurrent(words[6 + cell]);
+    status.cellPower[cell] = words[10 + cell] / 100.0;  // cW to W
+  }
+  status.batVoltage = convertVoltage((uint16_t)words[4]);
+  status.packVoltage = convertVoltage((uint16_t)words[5]);
+  status.power = words[14] / 100.0;
+  status.averagePower = words[15] / 100.0;
+
+  return status;
+}
+
 String BQ4050::getDAStatus2() {
+  BQ4050_BUS_SCOPE();
   return readSBSStringWithSmartPEC(BQ4050_CMD_DA_STATUS_2);
 }
 
+DAStatus2 BQ4050::getDAStatus2Data() {
+  BQ4050_BUS_SCOPE();
+  uint8_t data[MAX_BLOCK_LENGTH];
+  uint8_t length = readMirroredBlock(BQ4050_CMD_DA_STATUS_2, data, sizeof(data));
+
+  if (_lastError != BQ4050_ERROR_NONE) {
+    length = 0;
+  } else if (length < 14) {
+    setError(BQ4050_ERROR_UNEXPECTED_RESPONSE);
+    length = 0;
+  }
+
+  return decodeDAStatus2(data, length);
+}
+
+DAStatus2 BQ4050::decodeDAStatus2(const uint8_t* data, uint8_t length) {
+  DAStatus2 status;
+  memset(&status, 0, sizeof(status));
+  status.length = length;
+  if (length < 14) {
+    return status;
+  }
+
+  // Seven little-endian words in 0.1K: Int, TS1-TS4, Cell, FET
+  float temps[7];
+  for (uint8_t i = 0; i < 7; i++) {
+    temps[i] = convertTemperature(data[i * 2] | (data[i * 2 + 1] << 8));
+  }
+  status.internal = temps[0];
+  status.ts1 = temps[1];
+  status.ts2 = temps[2];
+  status.ts3 = temps[3];
+  status.ts4 = temps[4];
+  status.cellTemp = temps[5];
+  status.fetTemp = temps[6];
+
+  return status;
+}
+
 // Device Identification Commands
 uint16_t BQ4050::getDeviceType() {
-  return manufacturerAccess16(BQ4050_MAC_DEVICE_TYPE);  // Manufacturer Access 0x0001
+  BQ4050_BUS_SCOPE();
+  // Manufacturer Access 0x0001
+  IDENTITY_CACHED(IDENTITY_DEVICE_TYPE, deviceType, manufacturerAccess16(BQ4050_MAC_DEVICE_TYPE));
 }
 
 uint16_t BQ4050::getFirmwareVersion() {
-  return manufacturerAccess16(BQ4050_MAC_FIRMWARE_VERSION);  // Manufacturer Access 0x0002
+  BQ4050_BUS_SCOPE();
+  // Manufacturer Access 0x0002
+  IDENTITY_CACHED(IDENTITY_FIRMWARE_VERSION, firmwareVersion, manufacturerAccess16(BQ4050_MAC_FIRMWARE_VERSION));
 }
 
 uint16_t BQ4050::getHardwareVersion() {
-  return manufacturerAccess16(BQ4050_MAC_HARDWARE_VERSION);  // Manufacturer Access 0x0003
+  BQ4050_BUS_SCOPE();
+  // Manufacturer Access 0x0003
+  IDENTITY_CACHED(IDENTITY_HARDWARE_VERSION, hardwareVersion, manufacturerAccess16(BQ4050_MAC_HARDWARE_VERSION));
 }
 
 uint16_t BQ4050::getIFChecksum() {
+  BQ4050_BUS_SCOPE();
   return manufacturerAccess16(BQ4050_MAC_IF_CHECKSUM);  // [SEALED] Manufacturer Access 0x0004
 }
 
 uint16_t BQ4050::getStaticDFSignature() {
+  BQ4050_BUS_SCOPE();
   return manufacturerAccess16(BQ4050_MAC_STATIC_DF_SIGNATURE);  // [SEALED] Manufacturer Access 0x0005
 }
 
 uint16_t BQ4050::getAllDFSignature() {
+  BQ4050_BUS_SCOPE();
   return manufacturerAccess16(BQ4050_MAC_ALL_DF_SIGNATURE);  // [SEALED] Manufacturer Access 0x0009
 }
 
 // Enhanced manufacturer access functions that return full data blocks
 String BQ4050::getDeviceTypeBlock() {
+  BQ4050_BUS_SCOPE();
   // Send manufacturer access command for device type
-  if (!writeRegister16(0x00, BQ4050_MAC_DEVICE_TYPE)) {
+  if (!startManufacturerAccess(BQ4050_MAC_DEVICE_TYPE)) {
     return "Error: Failed to send command";
   }
-  delay(5);
   
   // Read the full data block from ManufacturerData (0x23)
-  return readSBSString(BQ4050_CMD_MANUFACTURER_DATA);
+  return completeManufacturerAccessBlock();
 }
 
 String BQ4050::getFirmwareVersionBlock() {
+  BQ4050_BUS_SCOPE();
   // Send manufacturer access command for firmware version
-  if (!writeRegister16(0x00, BQ4050_MAC_FIRMWARE_VERSION)) {
+  if (!startManufacturerAccess(BQ4050_MAC_FIRMWARE_VERSION)) {
     return "Error: Failed to send command";
   }
-  delay(5);
   
   // Read the full data block from ManufacturerData (0x23)
-  String rawData = readSBSString(BQ4050_CMD_MANUFACTURER_DATA);
+  String rawData = completeManufacturerAccessBlock();
   
   // Parse the firmware version format: ddDDvvVVbbBBTTzzZZRREE
   if (rawData.length() >= 10) {
@@ -524,202 +2164,729 @@ String BQ4050::getFirmwareVersionBlock() {
       result += "Device:" + String(deviceNum, HEX) + " Ver:" + String(version, HEX) + 
                " Build:" + String(build, HEX) + " Type:" + String(fwType, HEX);
     }
-    return result;
+    return result;
+  }
+  
+  return rawData; // Return raw data if parsing fails
+}
+
+String BQ4050::getHardwareVersionBlock() {
+  BQ4050_BUS_SCOPE();
+  // Send manufacturer access command for hardware version
+  if (!startManufacturerAccess(BQ4050_MAC_HARDWARE_VERSION)) {
+    return "Error: Failed to send command";
+  }
+  
+  // Read the full data block from ManufacturerData (0x23)
+  return completeManufacturerAccessBlock();
+}
+
+String BQ4050::getManufacturerName() {
+  BQ4050_BUS_SCOPE();
+  // Regular SBS command 0x20
+  IDENTITY_CACHED(IDENTITY_MANUFACTURER_NAME, manufacturerName, readSBSString(BQ4050_CMD_MANUFACTURER_NAME));
+}
+
+String BQ4050::getDeviceName() {
+  BQ4050_BUS_SCOPE();
+  // Regular SBS command 0x21
+  IDENTITY_CACHED(IDENTITY_DEVICE_NAME, deviceName, readSBSString(BQ4050_CMD_DEVICE_NAME));
+}
+
+String BQ4050::getDeviceChemistry() {
+  BQ4050_BUS_SCOPE();
+  // Regular SBS command 0x22
+  IDENTITY_CACHED(IDENTITY_DEVICE_CHEMISTRY, deviceChemistry, readSBSString(BQ4050_CMD_DEVICE_CHEMISTRY));
+}
+
+uint32_t BQ4050::getLifetimeDataBlock1() {
+  BQ4050_BUS_SCOPE();
+  return manufacturerAccess32(BQ4050_MAC_LIFETIME_DATA_BLOCK_1);
+}
+
+uint32_t BQ4050::getLifetimeDataBlock2() {
+  BQ4050_BUS_SCOPE();
+  return manufacturerAccess32(BQ4050_MAC_LIFETIME_DATA_BLOCK_2);
+}
+
+uint32_t BQ4050::getLifetimeDataBlock3() {
+  BQ4050_BUS_SCOPE();
+  return manufacturerAccess32(BQ4050_MAC_LIFETIME_DATA_BLOCK_3);
+}
+
+// FET Control
+bool BQ4050::enableChargeFET() {
+  BQ4050_BUS_SCOPE();
+  return manufacturerAccessWrite(BQ4050_MAC_CHARGE_FET_CONTROL, 0x0001);
+}
+
+bool BQ4050::disableChargeFET() {
+  BQ4050_BUS_SCOPE();
+  return manufacturerAccessWrite(BQ4050_MAC_CHARGE_FET_CONTROL, 0x0000);
+}
+
+bool BQ4050::enableDischargeFET() {
+  BQ4050_BUS_SCOPE();
+  return manufacturerAccessWrite(BQ4050_MAC_DISCHARGE_FET_CONTROL, 0x0001);
+}
+
+bool BQ4050::disableDischargeFET() {
+  BQ4050_BUS_SCOPE();
+  return manufacturerAccessWrite(BQ4050_MAC_DISCHARGE_FET_CONTROL, 0x0000);
+}
+
+bool BQ4050::enablePrechargeFET() {
+  BQ4050_BUS_SCOPE();
+  return manufacturerAccessWrite(BQ4050_MAC_PRECHARGE_FET_CONTROL, 0x0001);
+}
+
+bool BQ4050::disablePrechargeFET() {
+  BQ4050_BUS_SCOPE();
+  return manufacturerAccessWrite(BQ4050_MAC_PRECHARGE_FET_CONTROL, 0x0000);
+}
+
+bool BQ4050::setFETControl(uint8_t control) {
+  BQ4050_BUS_SCOPE();
+  return manufacturerAccessWrite(BQ4050_MAC_FET_CONTROL, control);
+}
+
+// Device Control
+bool BQ4050::enterCalibrationMode() {
+  BQ4050_BUS_SCOPE();
+  return manufacturerAccessWrite(BQ4050_MAC_CALIBRATION_MODE, 0x0001);
+}
+
+bool BQ4050::sealDevice() {
+  BQ4050_BUS_SCOPE();
+  if (!releaseDataFlashCache()) {
+    return false;
+  }
+  invalidateSecurityMode();
+  return manufacturerAccessWrite(BQ4050_MAC_SEAL_DEVICE, 0x0000);
+}
+
+bool BQ4050::resetDevice() {
+  BQ4050_BUS_SCOPE();
+  if (!releaseDataFlashCache()) {
+    return false;
+  }
+  invalidateIdentity();
+  invalidateShadow();
+  invalidateSecurityMode();
+  return manufacturerAccessWrite(BQ4050_MAC_RESET_DEVICE, 0x0000);
+}
+
+bool BQ4050::enterSleepMode() {
+  BQ4050_BUS_SCOPE();
+  return manufacturerAccessWrite(BQ4050_MAC_SLEEP_MODE, 0x0000);
+}
+
+bool BQ4050::enterShutdownMode() {
+  BQ4050_BUS_SCOPE();
+  return manufacturerAccessWrite(BQ4050_MAC_SHUTDOWN_MODE, 0x0000);
+}
+
+// Security Mode Detection
+BQ4050_SecurityMode BQ4050::getSecurityMode() {
+  BQ4050_BUS_SCOPE();
+  if (_lastSecurityMode != BQ4050_SECURITY_UNKNOWN) {
+    setError(BQ4050_ERROR_NONE);
+    return _lastSecurityMode;
+  }
+  return refreshSecurityMode();
+}
+
+BQ4050_SecurityMode BQ4050::refreshSecurityMode() {
+  BQ4050_BUS_SCOPE();
+  // observeOperationStatus() decodes [SEC1,SEC0] into the cache
+  uint32_t operationStatus = 0;
+  if (!readOperationStatus(operationStatus)) {
+    return BQ4050_SECURITY_UNKNOWN;
+  }
+  return _lastSecurityMode;
+}
+
+void BQ4050::invalidateSecurityMode() {
+  _lastSecurityMode = BQ4050_SECURITY_UNKNOWN;
+}
+
+String BQ4050::getSecurityModeString() {
+  BQ4050_BUS_SCOPE();
+  BQ4050_SecurityMode mode = getSecurityMode();
+  switch (mode) {
+    case BQ4050_SECURITY_SEALED: return "Sealed";
+    case BQ4050_SECURITY_UNSEALED: return "Unsealed";
+    case BQ4050_SECURITY_FULL_ACCESS: return "Full Access";
+    default: return "Unknown";
+  }
+}
+
+bool BQ4050::isSealed() {
+  BQ4050_BUS_SCOPE();
+  return getSecurityMode() == BQ4050_SECURITY_SEALED;
+}
+
+bool BQ4050::isUnsealed() {
+  BQ4050_BUS_SCOPE();
+  BQ4050_SecurityMode mode = getSecurityMode();
+  return (mode == BQ4050_SECURITY_UNSEALED || mode == BQ4050_SECURITY_FULL_ACCESS);
+}
+
+bool BQ4050::hasFullAccess() {
+  BQ4050_BUS_SCOPE();
+  return getSecurityMode() == BQ4050_SECURITY_FULL_ACCESS;
+}
+
+bool BQ4050::unsealDevice(uint16_t key1, uint16_t key2) {
+  BQ4050_BUS_SCOPE();
+  return writeSecurityKey(key1, key2, BQ4050_SECURITY_UNSEALED);
+}
+
+bool BQ4050::enterFullAccess(uint16_t key1, uint16_t key2) {
+  BQ4050_BUS_SCOPE();
+  return writeSecurityKey(key1, key2, BQ4050_SECURITY_FULL_ACCESS);
+}
+
+bool BQ4050::writeSecurityKey(uint16_t key1, uint16_t key2, BQ4050_SecurityMode target) {
+  // Both words go to ManufacturerAccess() back to back; hold the bus so no other
+  // driver's MAC command lands in between
+  BusLockScope busLock(this);
+  if (!busLock.held()) {
+    return false;
+  }
+  if (!releaseDataFlashCache()) {
+    return false;
+  }
+  invalidateSecurityMode();
+  if (!writeRegister16(0x00, key1) || !writeRegister16(0x00, key2)) {
+    return false;
+  }
+
+  sleepMicroseconds(_macDelayUs);
+  BQ4050_SecurityMode mode = refreshSecurityMode();
+  if (mode == BQ4050_SECURITY_UNKNOWN) {
+    return false;
+  }
+  if (mode < target) {
+    BQ4050_DEBUG_PRINT("Security key rejected");
+    setError(BQ4050_ERROR_ACCESS_DENIED);
+    return false;
+  }
+  return true;
+}
+
+bool BQ4050::requireAccess(BQ4050_SecurityMode level) {
+  // Only a known mode is enforced; finding it out would cost the bus read this avoids
+  if (_lastSecurityMode == BQ4050_SECURITY_UNKNOWN || _lastSecurityMode >= level) {
+    return true;
+  }
+  setError(BQ4050_ERROR_ACCESS_DENIED);
+  return false;
+}
+
+uint8_t BQ4050::readMirroredBlock(uint8_t command, uint8_t* buffer, uint8_t length) {
+  // Sealed, 0x50-0x57 and 0x71/0x72 only answer through the MAC subcommand of the
+  // same number on 0x44; otherwise the direct SBS read is one transaction instead
+  // of a MAC write, wait and read
+  if (getSecurityMode() == BQ4050_SECURITY_SEALED) {
+    return readMACBlock(command, buffer, length);
+  }
+  return readBlock(command, buffer, length);
+}
+
+uint16_t BQ4050::readStatusRegister16(uint8_t reg) {
+  // H4 block: a plain word read would return the length byte as the low byte
+  uint8_t data[4];
+  uint8_t received = readMirroredBlock(reg, data, sizeof(data));
+  if (received < 2 || _lastError != BQ4050_ERROR_NONE) {
+    if (_lastError == BQ4050_ERROR_NONE) {
+      setError(BQ4050_ERROR_UNEXPECTED_RESPONSE);
+    }
+    return 0;
+  }
+  return data[0] | (data[1] << 8);
+}
+
+bool BQ4050::isSealedSBSCommand(uint8_t command) {
+  return command < SEALED_SBS_LIMIT || command == BQ4050_CMD_MANUFACTURER_INFO;
+}
+
+bool BQ4050::isSealedMACCommand(uint16_t command) {
+  // ManufacturerAccess() subcommands marked [SEALED] in the TRM
+  return (command >= BQ4050_MAC_DEVICE_TYPE && command <= 0x0009) || command == 0x0010 ||
+         (command >= BQ4050_MAC_SAFETY_ALERT && command <= 0x0058) || (command >= 0x0060 && command <= 0x0062) ||
+         (command >= 0x0070 && command <= 0x0072) || command == 0x007A;
+}
+
+BQ4050_SecurityMode BQ4050::securityModeFromOperationStatus(uint32_t operationStatus) {
+  switch ((operationStatus >> OPERATION_STATUS_SEC_SHIFT) & 0x03) {
+    case 0x03: return BQ4050_SECURITY_SEALED;
+    case 0x02: return BQ4050_SECURITY_UNSEALED;
+    case 0x01: return BQ4050_SECURITY_FULL_ACCESS;
+    default: return BQ4050_SECURITY_UNKNOWN;   // 00 is reserved
+  }
+}
+
+// Data Flash Access
+uint8_t BQ4050::readDataFlash(uint16_t address) {
+  BQ4050_BUS_SCOPE();
+  uint8_t data = 0;
+  if (!readDataFlashBlock(address, &data, 1)) {
+    return 0;
+  }
+  return data;
+}
+
+bool BQ4050::readDataFlashBlock(uint16_t address, uint8_t* buffer, uint16_t length) {
+  BQ4050_BUS_SCOPE();
+  if (buffer == nullptr || length == 0 || address < BQ4050_DATA_FLASH_START ||
+      (uint32_t)address + length - 1 > BQ4050_DATA_FLASH_END) {
+    setError(BQ4050_ERROR_INVALID_PARAMETER);
+    return false;
+  }
+  if (!requireAccess(BQ4050_SECURITY_UNSEALED)) {
+    return false;
+  }
+
+  if (!_dfCacheEnabled) {
+    return fetchDataFlash(address, buffer, length);
+  }
+
+  for (uint16_t i = 0; i < length; ) {
+    DataFlashCacheRow* row = getDataFlashCacheRow(address + i);
+    if (row == nullptr) {
+      return false;
+    }
+    uint8_t offset = (address + i) - row->base;
+    while (i < length && offset < DATA_FLASH_BLOCK_SIZE) {
+      buffer[i++] = row->data[offset++];
+    }
+  }
+
+  setError(BQ4050_ERROR_NONE);
+  return true;
+}
+
+bool BQ4050::fetchDataFlash(uint16_t address, uint8_t* buffer, uint16_t length) {
+  uint16_t offset = 0;
+  RetryState retry;
+  beginRetry(retry);
+  while (offset < length) {
+    uint16_t chunkAddress = address + offset;
+
+    // ManufacturerBlockAccess: block write of the start address...
+    BusLockScope busLock(this);
+    uint8_t request[2] = {(uint8_t)(chunkAddress & 0xFF), (uint8_t)((chunkAddress >> 8) & 0xFF)};
+    if (!busLock.held() || !writeBlock(BQ4050_CMD_MANUFACTURER_BLOCK_ACCESS, request, sizeof(request))) {
+      return false;
+    }
+    markManufacturerAccessPending(chunkAddress);
+    waitForManufacturerAccess();
+    endManufacturerAccess();
+
+    // ...then a block read returning the address echo followed by up to 32 data bytes
+    uint8_t block[MAX_BLOCK_LENGTH];
+    uint8_t received = readBlock(BQ4050_CMD_MANUFACTURER_BLOCK_ACCESS, block, sizeof(block));
+    if (_lastError != BQ4050_ERROR_NONE) {
+      return false;
+    }
+
+    if (received <= 2 || block[0] != request[0] || block[1] != request[1]) {
+      // Another master issued its own MAC command between our write and read
+      BQ4050_DEBUG_PRINTF("Data flash echo mismatch at 0x%04X", chunkAddress);
+      _retryStats.arbitrationLost++;
+      if (shouldRetry(retry, RETRY_ON_BUS_ERROR)) {
+        continue;
+      }
+      setError(BQ4050_ERROR_UNEXPECTED_RESPONSE);
+      return false;
+    }
+
+    uint16_t count = received - 2;
+    if (count > length - offset) {
+      count = length - offset;
+    }
+    memcpy(buffer + offset, block + 2, count);
+    offset += count;
+
+    // Every chunk gets the whole retry budget, so glitches early in a long read
+    // cannot leave the later chunks without retries
+    endRetry(retry);
+    beginRetry(retry);
   }
-  
-  return rawData; // Return raw data if parsing fails
+
+  BQ4050_DEBUG_PRINTF("Read %d data flash bytes from 0x%04X", length, address);
+  return true;
 }
 
-String BQ4050::getHardwareVersionBlock() {
-  // Send manufacturer access command for hardware version
-  if (!writeRegister16(0x00, BQ4050_MAC_HARDWARE_VERSION)) {
-    return "Error: Failed to send command";
+bool BQ4050::writeDataFlash(uint16_t address, uint8_t data) {
+  BQ4050_BUS_SCOPE();
+  if (address < BQ4050_DATA_FLASH_START || address > BQ4050_DATA_FLASH_END) {
+    setError(BQ4050_ERROR_INVALID_PARAMETER);
+    return false;
   }
-  delay(5);
-  
-  // Read the full data block from ManufacturerData (0x23)
-  return readSBSString(BQ4050_CMD_MANUFACTURER_DATA);
-}
 
-String BQ4050::getManufacturerName() {
-  return readSBSString(BQ4050_CMD_MANUFACTURER_NAME);  // Regular SBS command 0x20
+  return writeDataFlashBlock(address, &data, 1);
 }
 
-String BQ4050::getDeviceName() {
-  return readSBSString(BQ4050_CMD_DEVICE_NAME);  // Regular SBS command 0x21
-}
+bool BQ4050::writeDataFlashBlock(uint16_t address, const uint8_t* data, uint16_t length) {
+  BQ4050_BUS_SCOPE();
+  if (data == nullptr || length == 0 || address < BQ4050_DATA_FLASH_START ||
+      (uint32_t)address + length - 1 > BQ4050_DATA_FLASH_END) {
+    setError(BQ4050_ERROR_INVALID_PARAMETER);
+    return false;
+  }
+  if (!requireAccess(BQ4050_SECURITY_UNSEALED)) {
+    return false;
+  }
 
-String BQ4050::getDeviceChemistry() {
-  return readSBSString(BQ4050_CMD_DEVICE_CHEMISTRY);  // Regular SBS command 0x22
-}
+  if (_dfCacheEnabled) {
+    for (uint16_t i = 0; i < length; ) {
+      DataFlashCacheRow* row = getDataFlashCacheRow(address + i);
+      if (row == nullptr) {
+        return false;
+      }
+      uint8_t offset = (address + i) - row->base;
+      while (i < length && offset < DATA_FLASH_BLOCK_SIZE) {
+        // Unchanged bytes never become dirty, so they cost no program cycles
+        if (row->data[offset] != data[i]) {
+          row->data[offset] = data[i];
+          row->dirtyMask |= (uint32_t)1 << offset;
+        }
+        offset++;
+        i++;
+      }
+    }
+    setError(BQ4050_ERROR_NONE);
+    return true;
+  }
 
-uint32_t BQ4050::getLifetimeDataBlock1() {
-  return manufacturerAccess32(BQ4050_MAC_LIFETIME_DATA_BLOCK_1);
-}
+  // Runs left over from a failed flush stay ahead of later writes, so those are
+  // staged behind them rather than overtaking them on the bus
+  if (_dfBatchDepth > 0 || _dfBatchCount > 0) {
+    bool success = true;
+    for (uint16_t i = 0; i < length; i++) {
+      success &= stageDataFlashWrite(address + i, data[i]);
+    }
+    return success;
+  }
 
-uint32_t BQ4050::getLifetimeDataBlock2() {
-  return manufacturerAccess32(BQ4050_MAC_LIFETIME_DATA_BLOCK_2);
+  return programDataFlash(address, data, length);
 }
 
-uint32_t BQ4050::getLifetimeDataBlock3() {
-  return manufacturerAccess32(BQ4050_MAC_LIFETIME_DATA_BLOCK_3);
-}
+bool BQ4050::programDataFlash(uint16_t address, const uint8_t* data, uint16_t length) {
+  // Command, byte count, the 2-byte address and PEC share the transport's transmit buffer
+  uint8_t overhead = _pecEnabled ? 5 : 4;
+  uint8_t maxLength = _transport->maxTransferLength();
+  if (maxLength <= overhead) {
+    setError(BQ4050_ERROR_INVALID_PARAMETER);  // No room for even one data byte
+    return false;
+  }
+  uint8_t chunkSize = DATA_FLASH_BLOCK_SIZE;
+  if (chunkSize > maxLength - overhead) {
+    chunkSize = maxLength - overhead;
+  }
 
-// FET Control
-bool BQ4050::enableChargeFET() {
-  return manufacturerAccessWrite(BQ4050_MAC_CHARGE_FET_CONTROL, 0x0001);
-}
+  uint16_t offset = 0;
+  while (offset < length) {
+    uint16_t chunkAddress = address + offset;
+    uint8_t count = (length - offset > chunkSize) ? chunkSize : (uint8_t)(length - offset);
 
-bool BQ4050::disableChargeFET() {
-  return manufacturerAccessWrite(BQ4050_MAC_CHARGE_FET_CONTROL, 0x0000);
-}
+    // ManufacturerBlockAccess block = start address + data, little endian
+    uint8_t block[2 + DATA_FLASH_BLOCK_SIZE];
+    block[0] = chunkAddress & 0xFF;
+    block[1] = (chunkAddress >> 8) & 0xFF;
+    memcpy(block + 2, data + offset, count);
 
-bool BQ4050::enableDischargeFET() {
-  return manufacturerAccessWrite(BQ4050_MAC_DISCHARGE_FET_CONTROL, 0x0001);
-}
+    if (!writeBlock(BQ4050_CMD_MANUFACTURER_BLOCK_ACCESS, block, count + 2)) {
+      return false;
+    }
+    _dfProgramUs = micros();
+    _dfProgramPending = true;
+    offset += count;
+  }
 
-bool BQ4050::disableDischargeFET() {
-  return manufacturerAccessWrite(BQ4050_MAC_DISCHARGE_FET_CONTROL, 0x0000);
+  BQ4050_DEBUG_PRINTF("Wrote %d data flash bytes to 0x%04X", length, address);
+  return true;
 }
 
-bool BQ4050::enablePrechargeFET() {
-  return manufacturerAccessWrite(BQ4050_MAC_PRECHARGE_FET_CONTROL, 0x0001);
+void BQ4050::waitForDataFlashProgram() {
+  // The gauge is busy programming after a data flash write and drops MAC traffic
+  // sent meanwhile, whether the next write comes from this call or a later one
+  if (!_dfProgramPending) {
+    return;
+  }
+  uint32_t elapsed = micros() - _dfProgramUs;
+  _dfProgramPending = false;
+  if (elapsed < _macDelayUs) {
+    sleepMicroseconds(_macDelayUs - elapsed);
+  }
 }
 
-bool BQ4050::disablePrechargeFET() {
-  return manufacturerAccessWrite(BQ4050_MAC_PRECHARGE_FET_CONTROL, 0x0000);
+// Data Flash Write Combining
+void BQ4050::beginDataFlashBatch() {
+  _dfBatchDepth++;
 }
 
-bool BQ4050::setFETControl(uint8_t control) {
-  return manufacturerAccessWrite(BQ4050_MAC_FET_CONTROL, control);
+bool BQ4050::commitDataFlashBatch() {
+  BQ4050_BUS_SCOPE();
+  if (_dfBatchDepth == 0) {
+    if (_dfBatchCount > 0) {
+      return flushDataFlashBatch();  // Retry what a failed flush left staged
+    }
+    setError(BQ4050_ERROR_INVALID_PARAMETER);
+    return false;
+  }
+  if (--_dfBatchDepth > 0) {
+    return true;  // Outer batch flushes
+  }
+  return flushDataFlashBatch();
 }
 
-// Device Control
-bool BQ4050::enterCalibrationMode() {
-  return manufacturerAccessWrite(BQ4050_MAC_CALIBRATION_MODE, 0x0001);
+void BQ4050::discardDataFlashBatch() {
+  _dfBatchCount = 0;
+  _dfBatchDepth = 0;
 }
 
-bool BQ4050::sealDevice() {
-  return manufacturerAccessWrite(BQ4050_MAC_SEAL_DEVICE, 0x0000);
-}
+bool BQ4050::stageDataFlashWrite(uint16_t address, uint8_t data) {
+  // Sorted insert; a repeated address simply takes the newest value
+  uint8_t i = 0;
+  while (i < _dfBatchCount && _dfBatch[i].address < address) {
+    i++;
+  }
+  if (i < _dfBatchCount && _dfBatch[i].address == address) {
+    _dfBatch[i].value = data;
+    return true;
+  }
 
-bool BQ4050::resetDevice() {
-  return manufacturerAccessWrite(BQ4050_MAC_RESET_DEVICE, 0x0000);
-}
+  bool success = true;
+  if (_dfBatchCount >= BQ4050_DF_BATCH_SIZE) {
+    success = flushDataFlashBatch();
+    if (_dfBatchCount >= BQ4050_DF_BATCH_SIZE) {
+      return false;  // Nothing could be flushed; the error is already set
+    }
+    i = 0;
+    while (i < _dfBatchCount && _dfBatch[i].address < address) {
+      i++;
+    }
+  }
 
-bool BQ4050::enterSleepMode() {
-  return manufacturerAccessWrite(BQ4050_MAC_SLEEP_MODE, 0x0000);
+  for (uint8_t j = _dfBatchCount; j > i; j--) {
+    _dfBatch[j] = _dfBatch[j - 1];
+  }
+  _dfBatch[i].address = address;
+  _dfBatch[i].value = data;
+  _dfBatchCount++;
+  return success;
 }
 
-bool BQ4050::enterShutdownMode() {
-  return manufacturerAccessWrite(BQ4050_MAC_SHUTDOWN_MODE, 0x0000);
-}
+bool BQ4050::flushDataFlashBatch() {
+  bool success = true;
+  uint8_t runs = 0;
+  uint8_t i = 0;
+  uint8_t kept = 0;
+
+  while (i < _dfBatchCount) {
+    // Gather one contiguous run
+    uint8_t run[DATA_FLASH_BLOCK_SIZE];
+    uint8_t runStart = i;
+    uint16_t runAddress = _dfBatch[i].address;
+    uint8_t runLength = 0;
+    while (i < _dfBatchCount && runLength < DATA_FLASH_BLOCK_SIZE &&
+           _dfBatch[i].address == runAddress + runLength) {
+      run[runLength++] = _dfBatch[i++].value;
+    }
 
-// Security Mode Detection
-BQ4050_SecurityMode BQ4050::getSecurityMode() {
-  // Get the Manufacturing Status register (0x57)
-  uint16_t mfgStatus = getManufacturingStatus();
-  
-  if (_lastError != BQ4050_ERROR_NONE) {
-    return BQ4050_SECURITY_UNKNOWN;
-  }
-  
-  // Check security status bits in Manufacturing Status
-  // Bit 13: SEAL (0 = Sealed, 1 = Unsealed/Full Access)
-  // Bit 14: Full Access (0 = No, 1 = Yes)
-  bool sealed = (mfgStatus & 0x2000) == 0;        // Bit 13
-  bool fullAccess = (mfgStatus & 0x4000) != 0;    // Bit 14
-  
-  if (sealed) {
-    return BQ4050_SECURITY_SEALED;
-  } else if (fullAccess) {
-    return BQ4050_SECURITY_FULL_ACCESS;
-  } else {
-    return BQ4050_SECURITY_UNSEALED;
+    if (programDataFlash(runAddress, run, runLength)) {
+      clearDataFlashDirty(runAddress, runLength);
+    } else {
+      // Keep the failed run staged, still sorted, for commitDataFlashBatch() to retry
+      for (uint8_t j = runStart; j < i; j++) {
+        _dfBatch[kept++] = _dfBatch[j];
+      }
+      success = false;
+    }
+    runs++;
   }
+
+  BQ4050_DEBUG_PRINTF("Flushed %d staged data flash bytes in %d block writes, %d left staged",
+                      _dfBatchCount - kept, runs, kept);
+  _dfBatchCount = kept;
+  return success;
 }
 
-String BQ4050::getSecurityModeString() {
-  BQ4050_SecurityMode mode = getSecurityMode();
-  switch (mode) {
-    case BQ4050_SECURITY_SEALED: return "Sealed";
-    case BQ4050_SECURITY_UNSEALED: return "Unsealed";
-    case BQ4050_SECURITY_FULL_ACCESS: return "Full Access";
-    default: return "Unknown";
+// Data Flash Shadow Cache
+void BQ4050::enableDataFlashCache(bool enable) {
+  if (!enable && _dfCacheEnabled && hasUncommittedChanges()) {
+    BQ4050_DEBUG_PRINT("Data flash cache disabled with uncommitted changes; committing");
+    if (!commit()) {
+      // Stay enabled so the changes are neither lost nor hidden; the error is set
+      BQ4050_DEBUG_PRINT("Commit failed; data flash cache left enabled");
+      return;
+    }
   }
+  _dfCacheEnabled = enable;
+  invalidateDataFlashCache();
 }
 
-bool BQ4050::isSealed() {
-  return getSecurityMode() == BQ4050_SECURITY_SEALED;
+bool BQ4050::isDataFlashCacheEnabled() const {
+  return _dfCacheEnabled;
 }
 
-bool BQ4050::isUnsealed() {
-  BQ4050_SecurityMode mode = getSecurityMode();
-  return (mode == BQ4050_SECURITY_UNSEALED || mode == BQ4050_SECURITY_FULL_ACCESS);
+bool BQ4050::hasUncommittedChanges() const {
+  for (uint8_t i = 0; i < BQ4050_DF_CACHE_ROWS; i++) {
+    if (_dfCache[i].valid && _dfCache[i].dirtyMask != 0) {
+      return true;
+    }
+  }
+  return false;
 }
 
-bool BQ4050::hasFullAccess() {
-  return getSecurityMode() == BQ4050_SECURITY_FULL_ACCESS;
+bool BQ4050::commit() {
+  BQ4050_BUS_SCOPE();
+  bool success = true;
+
+  // Stage every dirty byte so contiguous changes across rows merge into one block write
+  beginDataFlashBatch();
+  for (uint8_t i = 0; i < BQ4050_DF_CACHE_ROWS; i++) {
+    DataFlashCacheRow& row = _dfCache[i];
+    if (!row.valid || row.dirtyMask == 0) {
+      continue;
+    }
+    for (uint8_t offset = 0; offset < DATA_FLASH_BLOCK_SIZE; offset++) {
+      if (row.dirtyMask & ((uint32_t)1 << offset)) {
+        success &= stageDataFlashWrite(row.base + offset, row.data[offset]);
+      }
+    }
+  }
+  // Each run clears its dirty bits once programmed, so a failed flush stays pending
+  success &= commitDataFlashBatch();
+
+  return success;
 }
 
-// Data Flash Access
-uint8_t BQ4050::readDataFlash(uint16_t address) {
-  if (address < BQ4050_DATA_FLASH_START || address > BQ4050_DATA_FLASH_END) {
-    setError(BQ4050_ERROR_INVALID_PARAMETER);
-    return 0;
+bool BQ4050::releaseDataFlashCache() {
+  // Sealing, reset and key writes change what the cache mirrors; write pending
+  // changes out first rather than dropping them
+  if (hasUncommittedChanges() && !commit()) {
+    BQ4050_DEBUG_PRINT("Uncommitted data flash changes could not be written");
+    return false;
   }
+  invalidateDataFlashCache();
+  return true;
+}
 
-  if (!manufacturerAccessWrite(0x44, address)) {
-    return 0;
+void BQ4050::invalidateDataFlashCache() {
+  for (uint8_t i = 0; i < BQ4050_DF_CACHE_ROWS; i++) {
+    if (_dfCache[i].valid && _dfCache[i].dirtyMask != 0) {
+      BQ4050_DEBUG_PRINTF("Keeping uncommitted data flash row 0x%04X", _dfCache[i].base);
+      continue;
+    }
+    _dfCache[i].valid = false;
   }
-  delay(5);
+}
 
-  return readRegister8(0x40);
+void BQ4050::discardDataFlashChanges() {
+  for (uint8_t i = 0; i < BQ4050_DF_CACHE_ROWS; i++) {
+    _dfCache[i].valid = false;
+    _dfCache[i].dirtyMask = 0;
+  }
 }
 
-bool BQ4050::writeDataFlash(uint16_t address, uint8_t data) {
-  if (address < BQ4050_DATA_FLASH_START || address > BQ4050_DATA_FLASH_END) {
-    setError(BQ4050_ERROR_INVALID_PARAMETER);
-    return false;
+BQ4050::DataFlashCacheRow* BQ4050::getDataFlashCacheRow(uint16_t address) {
+  uint16_t base = address & ~(uint16_t)(DATA_FLASH_BLOCK_SIZE - 1);
+  DataFlashCacheRow* victim = nullptr;
+
+  for (uint8_t i = 0; i < BQ4050_DF_CACHE_ROWS; i++) {
+    DataFlashCacheRow& row = _dfCache[i];
+    if (row.valid && row.base == base) {
+      row.lastUse = ++_dfCacheClock;
+      return &row;
+    }
+
+    // Prefer an empty slot, otherwise the least recently used row
+    if (victim == nullptr || (victim->valid && !row.valid)) {
+      victim = &row;
+    } else if (victim->valid &&
+               (uint8_t)(_dfCacheClock - row.lastUse) > (uint8_t)(_dfCacheClock - victim->lastUse)) {
+      victim = &row;
+    }
   }
 
-  if (!manufacturerAccessWrite(0x44, address)) {
-    return false;
+  if (victim->valid && victim->dirtyMask != 0 && !flushDataFlashCacheRow(*victim)) {
+    return nullptr;
   }
 
-  if (!writeRegister8(0x40, data)) {
-    return false;
+  victim->valid = false;
+  if (!fetchDataFlash(base, victim->data, DATA_FLASH_BLOCK_SIZE)) {
+    return nullptr;
   }
+  victim->base = base;
+  victim->valid = true;
+  victim->dirtyMask = 0;
+  victim->lastUse = ++_dfCacheClock;
+  return victim;
+}
 
-  return true;
+bool BQ4050::flushDataFlashCacheRow(DataFlashCacheRow& row) {
+  bool success = true;
+  beginDataFlashBatch();
+  for (uint8_t offset = 0; offset < DATA_FLASH_BLOCK_SIZE; offset++) {
+    if (row.dirtyMask & ((uint32_t)1 << offset)) {
+      success &= stageDataFlashWrite(row.base + offset, row.data[offset]);
+    }
+  }
+  success &= commitDataFlashBatch();
+  return success;
+}
+
+void BQ4050::clearDataFlashDirty(uint16_t address, uint8_t length) {
+  for (uint8_t i = 0; i < BQ4050_DF_CACHE_ROWS; i++) {
+    DataFlashCacheRow& row = _dfCache[i];
+    if (!row.valid) {
+      continue;
+    }
+    for (uint8_t j = 0; j < length; j++) {
+      uint16_t offset = (uint16_t)(address + j) - row.base;
+      if (offset < DATA_FLASH_BLOCK_SIZE) {
+        row.dirtyMask &= ~((uint32_t)1 << offset);
+      }
+    }
+  }
 }
 
 // Simple Status Methods
 bool BQ4050::isCharging() {
+  BQ4050_BUS_SCOPE();
   uint16_t status = getBatteryStatus();
   return (status & 0x0002) != 0; // CHARGE bit
 }
 
 bool BQ4050::isDischarging() {
+  BQ4050_BUS_SCOPE();
   uint16_t status = getBatteryStatus();
   return (status & 0x0001) != 0; // DISCHARGE bit
 }
 
 bool BQ4050::isBatteryHealthy() {
+  BQ4050_BUS_SCOPE();
   uint16_t safetyStatus = getSafetyStatus();
   uint16_t pfStatus = getPFStatus();
   return (safetyStatus == 0) && (pfStatus == 0);
 }
 
 uint16_t BQ4050::getEstimatedRuntime() {
+  BQ4050_BUS_SCOPE();
   return readRegister16(0x11); // RunTimeToEmpty
 }
 
 uint16_t BQ4050::getEstimatedChargeTime() {
+  BQ4050_BUS_SCOPE();
   return readRegister16(0x13); // AverageTimeToFull
 }
 
 uint8_t BQ4050::getStateOfHealth() {
+  BQ4050_BUS_SCOPE();
   uint16_t fullCapacity = getFullChargeCapacity();
   uint16_t designCapacity = getDesignCapacity();
   if (designCapacity == 0) return 0;
@@ -731,6 +2898,10 @@ BQ4050_Error BQ4050::getLastError() const {
   return _lastError;
 }
 
+uint8_t BQ4050::getLastTransportStatus() const {
+  return _lastTransportStatus;
+}
+
 String BQ4050::getErrorString(BQ4050_Error error) {
   switch (error) {
     case BQ4050_ERROR_NONE:
@@ -747,6 +2918,10 @@ String BQ4050::getErrorString(BQ4050_Error error) {
       return "PEC mismatch";
     case BQ4050_ERROR_DEVICE_NOT_FOUND:
       return "Device not found";
+    case BQ4050_ERROR_UNEXPECTED_RESPONSE:
+      return "Unexpected response";
+    case BQ4050_ERROR_ACCESS_DENIED:
+      return "Access denied";
     default:
       return "Unknown error";
   }
@@ -768,77 +2943,198 @@ void BQ4050::setError(BQ4050_Error error) {
   _lastError = error;
 }
 
-String BQ4050::readSBSString(uint8_t command) {
-  BQ4050_DEBUG_HEX("Reading SBS string from register", command);
-  
-  if (!safeBeginTransmission(command)) {
-    return "";
-  }
+uint8_t BQ4050::readBlock(uint8_t command, uint8_t* buffer, uint8_t maxLength) {
+  BQ4050_DEBUG_HEX("Reading SBS block from register", command);
 
-  // Read length byte first (SBS block read format)
-  if (safeRequestData(1) == 0) {
-    return "";
+  // Single repeated-start read: length byte, payload and PEC in one transaction.
+  // The gauge stops driving meaningful data after the block, so over-reading is
+  // harmless; reading past what the caller can keep only costs wire time.
+  uint8_t response[1 + MAX_BLOCK_LENGTH + 1];
+  uint8_t bytesToRead = 1 + (maxLength < MAX_BLOCK_LENGTH ? maxLength : MAX_BLOCK_LENGTH) + (_pecEnabled ? 1 : 0);
+  if (bytesToRead > _transport->maxTransferLength()) {
+    bytesToRead = _transport->maxTransferLength();
   }
 
-  uint8_t length = _wire->read();
-  BQ4050_DEBUG_PRINTF("SBS string length: %d", length);
-  
-  // Enhanced buffer overflow protection
-  if (length == 0) {
-    BQ4050_DEBUG_PRINT("Zero length string received");
-    return "";  // Empty string, not an error
-  }
-  
-  if (length > MAX_SBS_STRING_LENGTH) {
-    BQ4050_DEBUG_PRINTF("String too long: %d > %d", length, MAX_SBS_STRING_LENGTH);
-    setError(BQ4050_ERROR_INVALID_PARAMETER);
-    return "";
+  RetryState retry;
+  beginRetry(retry);
+  for (;;) {
+    uint8_t bytesReceived = readTransaction(command, response, bytesToRead, false, _responseDelayUs);
+    if (bytesReceived == 0) {
+      BQ4050_DEBUG_PRINT("Block read returned no data");
+      return 0;
+    }
+
+    uint8_t length = response[0];
+    BQ4050_DEBUG_PRINTF("SBS block length: %d", length);
+
+    // Enhanced buffer overflow protection
+    if (length > MAX_BLOCK_LENGTH) {
+      BQ4050_DEBUG_PRINTF("Block too long: %d > %d", length, MAX_BLOCK_LENGTH);
+      setError(BQ4050_ERROR_INVALID_PARAMETER);
+      return 0;
+    }
+
+    // PEC covers the length byte and the whole block, so it can only be checked
+    // when all of it arrived (the caller's buffer and the transport's both fit)
+    if (_pecEnabled) {
+      if (bytesReceived >= length + 2) {
+        if (!checkPEC(pecReadPrefix(command), response, length + 1, response[length + 1])) {
+          if (shouldRetry(retry, RETRY_ON_PEC_ERROR)) {
+            continue;
+          }
+          return 0; // Error already set by checkPEC
+        }
+      } else {
+        BQ4050_DEBUG_PRINT("Block PEC not received; validation skipped");
+      }
+    }
+
+    uint8_t count = length;
+    if (count > bytesReceived - 1) {
+      // Transport buffer is smaller than the block; keep what arrived
+      BQ4050_DEBUG_PRINTF("Block truncated to %d of %d bytes by transport buffer", bytesReceived - 1, length);
+      count = bytesReceived - 1;
+    }
+    if (count > maxLength) {
+      count = maxLength;
+    }
+
+    memcpy(buffer, response + 1, count);
+    endRetry(retry);
+    setError(BQ4050_ERROR_NONE);
+    return count;
   }
+}
 
-  // Request the actual string data with bounds check
-  uint8_t bytesToRead = _pecEnabled ? length + 1 : length; // +1 for PEC if enabled
-  if (safeRequestData(bytesToRead) == 0) {
+String BQ4050::readSBSString(uint8_t command) {
+  uint8_t buffer[MAX_SBS_STRING_LENGTH];
+  uint8_t length = readBlock(command, buffer, sizeof(buffer));
+  if (_lastError != BQ4050_ERROR_NONE) {
     return "";
   }
 
   // Read the string data with buffer overflow protection
   String result = "";
   result.reserve(length + 1);  // Pre-allocate to avoid multiple reallocations
-  
+
   for (uint8_t i = 0; i < length; i++) {
-    if (_wire->available() == 0) {
-      BQ4050_DEBUG_PRINTF("Unexpected end of data at byte %d of %d", i, length);
-      setError(BQ4050_ERROR_I2C_TIMEOUT);
-      break;
-    }
-    
-    char c = _wire->read();
+    char c = buffer[i];
     // Filter out invalid characters and add bounds check
     if (c >= 0x20 && c <= 0x7E) {  // Printable ASCII only (space to tilde)
       result += c;
     }
   }
 
-  // Handle PEC if enabled
-  if (_pecEnabled) {
-    _wire->read(); // Read and discard PEC byte
-    // TODO: Validate PEC for block read - more complex than single register PEC
-    BQ4050_DEBUG_PRINT("PEC validation skipped for block read");
-  }
-
-  setError(BQ4050_ERROR_NONE);
   return result;
 }
 
 
+// Field-mask Snapshot
+BatterySnapshot BQ4050::readSnapshot(uint32_t fields) {
+  BQ4050_BUS_SCOPE();
+  // SBS word sources, in the order the plan issues them
+  static const struct {
+    uint32_t field;
+    uint8_t reg;
+  } wordSources[] = {
+    {SNAPSHOT_VOLTAGE, BQ4050_CMD_VOLTAGE},
+    {SNAPSHOT_CURRENT, BQ4050_CMD_CURRENT},
+    {SNAPSHOT_AVERAGE_CURRENT, BQ4050_CMD_AVERAGE_CURRENT},
+    {SNAPSHOT_TEMPERATURE, BQ4050_CMD_TEMPERATURE},
+    {SNAPSHOT_RELATIVE_SOC, BQ4050_CMD_RELATIVE_STATE_OF_CHARGE},
+    {SNAPSHOT_ABSOLUTE_SOC, BQ4050_CMD_ABSOLUTE_STATE_OF_CHARGE},
+    {SNAPSHOT_REMAINING_CAPACITY, BQ4050_CMD_REMAINING_CAPACITY},
+    {SNAPSHOT_FULL_CHARGE_CAPACITY, BQ4050_CMD_FULL_CHARGE_CAPACITY},
+    {SNAPSHOT_RUN_TIME_TO_EMPTY, 0x11},   // RunTimeToEmpty
+    {SNAPSHOT_AVERAGE_TIME_TO_FULL, 0x13}, // AverageTimeToFull
+    {SNAPSHOT_BATTERY_STATUS, BQ4050_CMD_BATTERY_STATUS},
+    {SNAPSHOT_CYCLE_COUNT, BQ4050_CMD_CYCLE_COUNT},
+  };
+  const uint32_t daStatus1Fields = SNAPSHOT_CELL_VOLTAGES | SNAPSHOT_PACK_VOLTAGE | SNAPSHOT_BAT_VOLTAGE;
+
+  BatterySnapshot snapshot;
+  memset(&snapshot, 0, sizeof(snapshot));
+  uint32_t transfersBefore = _transferCount;
+
+  // Plan: one DAStatus1 block covers every cell/pack/BAT voltage. Voltage() stays
+  // a word read; depending on configuration it is not the sum of those cells.
+  bool readDAStatus1 = (fields & daStatus1Fields) != 0;
+
+  TransactionSchedule schedule;
+  int8_t slots[sizeof(wordSources) / sizeof(wordSources[0])];
+  for (uint8_t i = 0; i < sizeof(wordSources) / sizeof(wordSources[0]); i++) {
+    slots[i] = (fields & wordSources[i].field) ? schedule.addRead(wordSources[i].reg) : -1;
+  }
+  runSchedule(schedule);
+
+  for (uint8_t i = 0; i < sizeof(wordSources) / sizeof(wordSources[0]); i++) {
+    if (slots[i] < 0 || !schedule.reads[slots[i]].ok) {
+      continue;
+    }
+    uint16_t raw = schedule.reads[slots[i]].value;
+    snapshot.fields |= wordSources[i].field;
+
+    switch (wordSources[i].field) {
+      case SNAPSHOT_VOLTAGE: snapshot.voltage = convertVoltage(raw); break;
+      case SNAPSHOT_CURRENT: snapshot.current = convertCurrent((int16_t)raw); break;
+      case SNAPSHOT_AVERAGE_CURRENT: snapshot.averageCurrent = convertCurrent((int16_t)raw); break;
+      case SNAPSHOT_TEMPERATURE: snapshot.temperature = convertTemperature(raw); break;
+      case SNAPSHOT_RELATIVE_SOC: snapshot.relativeSOC = raw & 0xFF; break;
+      case SNAPSHOT_ABSOLUTE_SOC: snapshot.absoluteSOC = raw & 0xFF; break;
+      case SNAPSHOT_REMAINING_CAPACITY: snapshot.remainingCapacity = raw; break;
+      case SNAPSHOT_FULL_CHARGE_CAPACITY: snapshot.fullChargeCapacity = raw; break;
+      case SNAPSHOT_RUN_TIME_TO_EMPTY: snapshot.runTimeToEmpty = raw; break;
+      case SNAPSHOT_AVERAGE_TIME_TO_FULL: snapshot.averageTimeToFull = raw; break;
+      case SNAPSHOT_BATTERY_STATUS:
+        snapshot.batteryStatus = raw;
+        snapshot.charging = (raw & 0x0002) != 0;
+        snapshot.discharging = (raw & 0x0001) != 0;
+        break;
+      case SNAPSHOT_CYCLE_COUNT: snapshot.cycleCount = raw; break;
+    }
+  }
+
+  if (fields & SNAPSHOT_SAFETY_STATUS) {
+    snapshot.safetyStatus = getSafetyStatus();
+    if (_lastError == BQ4050_ERROR_NONE) {
+      snapshot.fields |= SNAPSHOT_SAFETY_STATUS;
+    }
+  }
+
+  if (readDAStatus1) {
+    DAStatus1 status = getDAStatus1Data();
+    if (status.length > 0) {
+      for (uint8_t cell = 0; cell < 4; cell++) {
+        snapshot.cellVoltage[cell] = status.cellVoltage[cell];
+      }
+      snapshot.batVoltage = status.batVoltage;
+      snapshot.packVoltage = status.packVoltage;
+      snapshot.fields |= (fields & daStatus1Fields);
+    }
+  }
+
+  // Counted at the transport, so sealed MAC-mirror reads show their 0x44 write too
+  uint32_t transfers = _transferCount - transfersBefore;
+  snapshot.transactions = transfers > 0xFF ? 0xFF : (uint8_t)transfers;
+
+  if (snapshot.fields != fields) {
+    BQ4050_DEBUG_PRINTF("Snapshot incomplete: wanted 0x%08lX, got 0x%08lX",
+                        (unsigned long)fields, (unsigned long)snapshot.fields);
+  }
+  return snapshot;
+}
+
 // Convenience Methods
 CellStatus BQ4050::getAllCellStatus() {
+  BQ4050_BUS_SCOPE();
   CellStatus status;
 
-  status.voltage1 = getCellVoltage1();
-  status.voltage2 = getCellVoltage2();
-  status.voltage3 = getCellVoltage3();
-  status.voltage4 = getCellVoltage4();
+  // One DAStatus1 block keeps the four voltages from the same sample
+  DAStatus1 daStatus = getDAStatus1Data();
+  status.voltage1 = daStatus.cellVoltage[0];
+  status.voltage2 = daStatus.cellVoltage[1];
+  status.voltage3 = daStatus.cellVoltage[2];
+  status.voltage4 = daStatus.cellVoltage[3];
 
   // Check balancing status from battery status register
   uint16_t batteryStatus = getBatteryStatus();
@@ -851,45 +3147,45 @@ CellStatus BQ4050::getAllCellStatus() {
 }
 
 TemperatureStatus BQ4050::getAllTemperatures() {
+  BQ4050_BUS_SCOPE();
   TemperatureStatus temps;
 
-  temps.internal = getTemperature();
-
-  // Read external thermistor temperatures (manufacturer access commands)
-  uint16_t ts1Raw = manufacturerAccess16(0x0070); // TS1 Temperature
-  uint16_t ts2Raw = manufacturerAccess16(0x0071); // TS2 Temperature
-  uint16_t ts3Raw = manufacturerAccess16(0x0072); // TS3 Temperature
-  uint16_t ts4Raw = manufacturerAccess16(0x0073); // TS4 Temperature
-  uint16_t cellTempRaw = manufacturerAccess16(0x0074); // Cell Temperature
-  uint16_t fetTempRaw = manufacturerAccess16(0x0075); // FET Temperature
-
-  temps.ts1 = convertTemperature(ts1Raw);
-  temps.ts2 = convertTemperature(ts2Raw);
-  temps.ts3 = convertTemperature(ts3Raw);
-  temps.ts4 = convertTemperature(ts4Raw);
-  temps.cellTemp = convertTemperature(cellTempRaw);
-  temps.fetTemp = convertTemperature(fetTempRaw);
+  // All seven sensors come back in one DAStatus2 block
+  DAStatus2 daStatus = getDAStatus2Data();
+  temps.internal = daStatus.internal;
+  temps.ts1 = daStatus.ts1;
+  temps.ts2 = daStatus.ts2;
+  temps.ts3 = daStatus.ts3;
+  temps.ts4 = daStatus.ts4;
+  temps.cellTemp = daStatus.cellTemp;
+  temps.fetTemp = daStatus.fetTemp;
 
   return temps;
 }
 
 BatteryInfo BQ4050::getCompleteBatteryStatus() {
+  BQ4050_BUS_SCOPE();
   BatteryInfo info;
 
-  info.voltage = getVoltage();
-  info.current = getCurrent();
-  info.temperature = getTemperature();
-  info.soc = getRelativeStateOfCharge();
-  info.cycleCount = getCycleCount();
-  info.remainingCapacity = getRemainingCapacity();
-  info.fullCapacity = getFullChargeCapacity();
-  info.batteryStatus = getBatteryStatus();
+  BatterySnapshot snapshot = readSnapshot(SNAPSHOT_VOLTAGE | SNAPSHOT_CURRENT | SNAPSHOT_TEMPERATURE |
+                                          SNAPSHOT_RELATIVE_SOC | SNAPSHOT_CYCLE_COUNT |
+                                          SNAPSHOT_REMAINING_CAPACITY | SNAPSHOT_FULL_CHARGE_CAPACITY |
+                                          SNAPSHOT_BATTERY_STATUS | SNAPSHOT_SAFETY_STATUS);
+
+  info.voltage = snapshot.voltage;
+  info.current = snapshot.current;
+  info.temperature = snapshot.temperature;
+  info.soc = snapshot.relativeSOC;
+  info.cycleCount = snapshot.cycleCount;
+  info.remainingCapacity = snapshot.remainingCapacity;
+  info.fullCapacity = snapshot.fullChargeCapacity;
+  info.batteryStatus = snapshot.batteryStatus;
 
-  info.charging = (info.batteryStatus & 0x0002) != 0;
-  info.discharging = (info.batteryStatus & 0x0001) != 0;
+  info.charging = snapshot.charging;
+  info.discharging = snapshot.discharging;
 
   // Safety status parsing
-  uint16_t safetyStatus = getSafetyStatus();
+  uint16_t safetyStatus = snapshot.safetyStatus;
   info.overVoltage = (safetyStatus & 0x0001) != 0;
   info.underVoltage = (safetyStatus & 0x0002) != 0;
   info.overTemperature = (safetyStatus & 0x0004) != 0;
@@ -901,10 +3197,11 @@ BatteryInfo BQ4050::getCompleteBatteryStatus() {
 }
 
 SafetyStatus BQ4050::getParsedSafetyStatus() {
+  BQ4050_BUS_SCOPE();
   SafetyStatus safety;
 
   safety.safetyAlert = getSafetyAlert();
-  safety.safetyStatusRaw = readRegister16(BQ4050_CMD_SAFETY_STATUS);
+  safety.safetyStatusRaw = readStatusRegister16(BQ4050_CMD_SAFETY_STATUS);
 
   // Parse safety status bits
   safety.overVoltage = (safety.safetyStatusRaw & 0x0001) != 0;
@@ -922,6 +3219,7 @@ SafetyStatus BQ4050::getParsedSafetyStatus() {
 
 // CEDV Methods Implementation
 CEDVStatus BQ4050::getCEDVStatus() {
+  BQ4050_BUS_SCOPE();
   CEDVStatus status;
 
   // Read CEDV status from gauging status register
@@ -939,44 +3237,54 @@ CEDVStatus BQ4050::getCEDVStatus() {
 }
 
 float BQ4050::getEDV0Threshold() {
+  BQ4050_BUS_SCOPE();
   uint16_t edv0Raw = manufacturerAccess16(0x0080); // EDV0 threshold
   return convertVoltage(edv0Raw);
 }
 
 float BQ4050::getEDV1Threshold() {
+  BQ4050_BUS_SCOPE();
   uint16_t edv1Raw = manufacturerAccess16(0x0081); // EDV1 threshold
   return convertVoltage(edv1Raw);
 }
 
 float BQ4050::getEDV2Threshold() {
+  BQ4050_BUS_SCOPE();
   uint16_t edv2Raw = manufacturerAccess16(0x0082); // EDV2 threshold
   return convertVoltage(edv2Raw);
 }
 
 bool BQ4050::isEDVCompensationEnabled() {
+  BQ4050_BUS_SCOPE();
   uint16_t cedvConfig = manufacturerAccess16(0x0083); // CEDV Configuration
   return (cedvConfig & 0x0001) != 0; // Compensation enable bit
 }
 
 CEDVConfig BQ4050::getCEDVConfig() {
+  BQ4050_BUS_SCOPE();
   CEDVConfig config;
+  uint8_t data[15] = {0};
+
+  // Read CEDV configuration parameters from data flash (0x4120-0x412E) in one block
+  readDataFlashBlock(0x4120, data, sizeof(data));
 
-  // Read CEDV configuration parameters from data flash
-  config.emf = readDataFlash(0x4120) | (readDataFlash(0x4121) << 8);
-  config.c0 = readDataFlash(0x4122) | (readDataFlash(0x4123) << 8);
-  config.r0 = readDataFlash(0x4124) | (readDataFlash(0x4125) << 8);
-  config.t0 = readDataFlash(0x4126) | (readDataFlash(0x4127) << 8);
-  config.r1 = readDataFlash(0x4128) | (readDataFlash(0x4129) << 8);
-  config.tc = readDataFlash(0x412A);
-  config.c1 = readDataFlash(0x412B);
-  config.ageFactor = readDataFlash(0x412C);
-  config.batteryLowPercent = readDataFlash(0x412D) | (readDataFlash(0x412E) << 8);
+  config.emf = data[0] | (data[1] << 8);
+  config.c0 = data[2] | (data[3] << 8);
+  config.r0 = data[4] | (data[5] << 8);
+  config.t0 = data[6] | (data[7] << 8);
+  config.r1 = data[8] | (data[9] << 8);
+  config.tc = data[10];
+  config.c1 = data[11];
+  config.ageFactor = data[12];
+  config.batteryLowPercent = data[13] | (data[14] << 8);
 
   return config;
 }
 
 bool BQ4050::setCEDVConfig(const CEDVConfig& config) {
+  BQ4050_BUS_SCOPE();
   bool success = true;
+  beginDataFlashBatch();
 
   // Write CEDV configuration parameters to data flash
   success &= writeDataFlash(0x4120, config.emf & 0xFF);
@@ -995,57 +3303,70 @@ bool BQ4050::setCEDVConfig(const CEDVConfig& config) {
   success &= writeDataFlash(0x412D, config.batteryLowPercent & 0xFF);
   success &= writeDataFlash(0x412E, (config.batteryLowPercent >> 8) & 0xFF);
 
+  success &= commitDataFlashBatch();
   return success;
 }
 
 bool BQ4050::enableEDVCompensation() {
+  BQ4050_BUS_SCOPE();
   return manufacturerAccessWrite(0x0083, 0x0001); // Enable CEDV
 }
 
 bool BQ4050::disableEDVCompensation() {
+  BQ4050_BUS_SCOPE();
   return manufacturerAccessWrite(0x0083, 0x0000); // Disable CEDV
 }
 
 bool BQ4050::setFixedEDV0(float voltage) {
+  BQ4050_BUS_SCOPE();
   uint16_t voltageRaw = (uint16_t)(voltage * 1000); // Convert to mV
   return manufacturerAccessWrite(0x0084, voltageRaw);
 }
 
 bool BQ4050::setFixedEDV1(float voltage) {
+  BQ4050_BUS_SCOPE();
   uint16_t voltageRaw = (uint16_t)(voltage * 1000); // Convert to mV
   return manufacturerAccessWrite(0x0085, voltageRaw);
 }
 
 bool BQ4050::setFixedEDV2(float voltage) {
+  BQ4050_BUS_SCOPE();
   uint16_t voltageRaw = (uint16_t)(voltage * 1000); // Convert to mV
   return manufacturerAccessWrite(0x0086, voltageRaw);
 }
 
 bool BQ4050::isUsingFixedEDV() {
+  BQ4050_BUS_SCOPE();
   return !isEDVCompensationEnabled();
 }
 
 CEDVProfile BQ4050::getCEDVProfile() {
+  BQ4050_BUS_SCOPE();
   CEDVProfile profile;
-
-  // Read CEDV profile from data flash (voltage at various DOD levels)
-  profile.voltage0DOD = readDataFlash(0x4140) | (readDataFlash(0x4141) << 8);
-  profile.voltage10DOD = readDataFlash(0x4142) | (readDataFlash(0x4143) << 8);
-  profile.voltage20DOD = readDataFlash(0x4144) | (readDataFlash(0x4145) << 8);
-  profile.voltage30DOD = readDataFlash(0x4146) | (readDataFlash(0x4147) << 8);
-  profile.voltage40DOD = readDataFlash(0x4148) | (readDataFlash(0x4149) << 8);
-  profile.voltage50DOD = readDataFlash(0x414A) | (readDataFlash(0x414B) << 8);
-  profile.voltage60DOD = readDataFlash(0x414C) | (readDataFlash(0x414D) << 8);
-  profile.voltage70DOD = readDataFlash(0x414E) | (readDataFlash(0x414F) << 8);
-  profile.voltage80DOD = readDataFlash(0x4150) | (readDataFlash(0x4151) << 8);
-  profile.voltage90DOD = readDataFlash(0x4152) | (readDataFlash(0x4153) << 8);
-  profile.voltage100DOD = readDataFlash(0x4154) | (readDataFlash(0x4155) << 8);
+  uint8_t data[22] = {0};
+
+  // Read CEDV profile from data flash (voltage at various DOD levels, 0x4140-0x4155)
+  readDataFlashBlock(0x4140, data, sizeof(data));
+
+  profile.voltage0DOD = data[0] | (data[1] << 8);
+  profile.voltage10DOD = data[2] | (data[3] << 8);
+  profile.voltage20DOD = data[4] | (data[5] << 8);
+  profile.voltage30DOD = data[6] | (data[7] << 8);
+  profile.voltage40DOD = data[8] | (data[9] << 8);
+  profile.voltage50DOD = data[10] | (data[11] << 8);
+  profile.voltage60DOD = data[12] | (data[13] << 8);
+  profile.voltage70DOD = data[14] | (data[15] << 8);
+  profile.voltage80DOD = data[16] | (data[17] << 8);
+  profile.voltage90DOD = data[18] | (data[19] << 8);
+  profile.voltage100DOD = data[20] | (data[21] << 8);
 
   return profile;
 }
 
 bool BQ4050::setCEDVProfile(const CEDVProfile& profile) {
+  BQ4050_BUS_SCOPE();
   bool success = true;
+  beginDataFlashBatch();
 
   // Write CEDV profile to data flash
   success &= writeDataFlash(0x4140, profile.voltage0DOD & 0xFF);
@@ -1071,20 +3392,25 @@ bool BQ4050::setCEDVProfile(const CEDVProfile& profile) {
   success &= writeDataFlash(0x4154, profile.voltage100DOD & 0xFF);
   success &= writeDataFlash(0x4155, (profile.voltage100DOD >> 8) & 0xFF);
 
+  success &= commitDataFlashBatch();
   return success;
 }
 
 CEDVSmoothingConfig BQ4050::getSmoothingConfig() {
+  BQ4050_BUS_SCOPE();
   CEDVSmoothingConfig config;
+  uint8_t data[9] = {0};
+
+  // Read smoothing configuration from data flash (0x4160-0x4168)
+  readDataFlashBlock(0x4160, data, sizeof(data));
 
-  // Read smoothing configuration from data flash
-  config.smoothingStartVoltage = readDataFlash(0x4160) | (readDataFlash(0x4161) << 8);
-  config.smoothingDeltaVoltage = readDataFlash(0x4162) | (readDataFlash(0x4163) << 8);
-  config.maxSmoothingCurrent = readDataFlash(0x4164) | (readDataFlash(0x4165) << 8);
-  config.eocSmoothCurrent = readDataFlash(0x4166);
-  config.eocSmoothCurrentTime = readDataFlash(0x4167);
+  config.smoothingStartVoltage = data[0] | (data[1] << 8);
+  config.smoothingDeltaVoltage = data[2] | (data[3] << 8);
+  config.maxSmoothingCurrent = data[4] | (data[5] << 8);
+  config.eocSmoothCurrent = data[6];
+  config.eocSmoothCurrentTime = data[7];
 
-  uint8_t smoothingFlags = readDataFlash(0x4168);
+  uint8_t smoothingFlags = data[8];
   config.smoothToEDV0 = (smoothingFlags & 0x01) != 0;
   config.smoothToEDV1 = (smoothingFlags & 0x02) != 0;
   config.extendedSmoothing = (smoothingFlags & 0x04) != 0;
@@ -1093,7 +3419,9 @@ CEDVSmoothingConfig BQ4050::getSmoothingConfig() {
 }
 
 bool BQ4050::setSmoothingConfig(const CEDVSmoothingConfig& config) {
+  BQ4050_BUS_SCOPE();
   bool success = true;
+  beginDataFlashBatch();
 
   success &= writeDataFlash(0x4160, config.smoothingStartVoltage & 0xFF);
   success &= writeDataFlash(0x4161, (config.smoothingStartVoltage >> 8) & 0xFF);
@@ -1110,23 +3438,28 @@ bool BQ4050::setSmoothingConfig(const CEDVSmoothingConfig& config) {
   if (config.extendedSmoothing) smoothingFlags |= 0x04;
   success &= writeDataFlash(0x4168, smoothingFlags);
 
+  success &= commitDataFlashBatch();
   return success;
 }
 
 bool BQ4050::isLearningDischarge() {
+  BQ4050_BUS_SCOPE();
   uint16_t gaugingStatus = getGaugingStatus();
   return (gaugingStatus & 0x0040) != 0; // Qualified discharge bit
 }
 
 uint16_t BQ4050::getQualifiedDischargeCount() {
+  BQ4050_BUS_SCOPE();
   return manufacturerAccess16(0x0087); // Qualified discharge count
 }
 
 bool BQ4050::resetLearning() {
+  BQ4050_BUS_SCOPE();
   return manufacturerAccessWrite(0x0088, 0x0000); // Reset learning data
 }
 
 CEDVInfo BQ4050::getCompleteCEDVInfo() {
+  BQ4050_BUS_SCOPE();
   CEDVInfo info;
 
   info.status = getCEDVStatus();
@@ -1162,11 +3495,13 @@ CEDVInfo BQ4050::getCompleteCEDVInfo() {
 
 // Settings Flash Configuration Methods
 CellCount BQ4050::getCellCount() {
+  BQ4050_BUS_SCOPE();
   uint8_t daConfig = readDataFlash(0x4000); // DA Configuration register
   return (CellCount)((daConfig >> 0) & 0x03); // CC1:CC0 bits
 }
 
 bool BQ4050::setCellCount(CellCount count) {
+  BQ4050_BUS_SCOPE();
   uint8_t daConfig = readDataFlash(0x4000);
   daConfig &= ~0x03; // Clear CC1:CC0 bits
   daConfig |= ((uint8_t)count & 0x03); // Set new cell count
@@ -1174,8 +3509,12 @@ bool BQ4050::setCellCount(CellCount count) {
 }
 
 DAConfiguration BQ4050::getDAConfiguration() {
+  BQ4050_BUS_SCOPE();
+  return decodeDAConfiguration(readDataFlash(0x4000));
+}
+
+DAConfiguration BQ4050::decodeDAConfiguration(uint8_t daReg) {
   DAConfiguration config;
-  uint8_t daReg = readDataFlash(0x4000);
 
   config.cellCount = (CellCount)(daReg & 0x03);
   config.nonRemovable = (daReg & 0x04) != 0;
@@ -1189,6 +3528,7 @@ DAConfiguration BQ4050::getDAConfiguration() {
 }
 
 bool BQ4050::setDAConfiguration(const DAConfiguration& config) {
+  BQ4050_BUS_SCOPE();
   uint8_t daReg = 0;
 
   daReg |= ((uint8_t)config.cellCount & 0x03);
@@ -1203,8 +3543,12 @@ bool BQ4050::setDAConfiguration(const DAConfiguration& config) {
 }
 
 FETOptions BQ4050::getFETOptions() {
+  BQ4050_BUS_SCOPE();
+  return decodeFETOptions(readDataFlash(0x4001)); // FET Options register
+}
+
+FETOptions BQ4050::decodeFETOptions(uint8_t fetReg) {
   FETOptions options;
-  uint8_t fetReg = readDataFlash(0x4001); // FET Options register
 
   options.prechargeComm = (fetReg & 0x01) != 0;
   options.chargeSuspendFET = (fetReg & 0x02) != 0;
@@ -1215,6 +3559,7 @@ FETOptions BQ4050::getFETOptions() {
 }
 
 bool BQ4050::setFETOptions(const FETOptions& options) {
+  BQ4050_BUS_SCOPE();
   uint8_t fetReg = 0;
 
   if (options.prechargeComm) fetReg |= 0x01;
@@ -1226,8 +3571,12 @@ bool BQ4050::setFETOptions(const FETOptions& options) {
 }
 
 PowerConfig BQ4050::getPowerConfig() {
+  BQ4050_BUS_SCOPE();
+  return decodePowerConfig(readDataFlash(0x4002)); // Power Configuration register
+}
+
+PowerConfig BQ4050::decodePowerConfig(uint8_t powerReg) {
   PowerConfig config;
-  uint8_t powerReg = readDataFlash(0x4002); // Power Configuration register
 
   config.autoShipEnable = (powerReg & 0x01) != 0;
 
@@ -1235,6 +3584,7 @@ PowerConfig BQ4050::getPowerConfig() {
 }
 
 bool BQ4050::setPowerConfig(const PowerConfig& config) {
+  BQ4050_BUS_SCOPE();
   uint8_t powerReg = 0;
 
   if (config.autoShipEnable) powerReg |= 0x01;
@@ -1243,8 +3593,12 @@ bool BQ4050::setPowerConfig(const PowerConfig& config) {
 }
 
 IOConfig BQ4050::getIOConfig() {
+  BQ4050_BUS_SCOPE();
+  return decodeIOConfig(readDataFlash(0x4003)); // I/O Configuration register
+}
+
+IOConfig BQ4050::decodeIOConfig(uint8_t ioReg) {
   IOConfig config;
-  uint8_t ioReg = readDataFlash(0x4003); // I/O Configuration register
 
   config.btpEnable = (ioReg & 0x01) != 0;
   config.btpPolarity = (ioReg & 0x02) != 0;
@@ -1253,6 +3607,7 @@ IOConfig BQ4050::getIOConfig() {
 }
 
 bool BQ4050::setIOConfig(const IOConfig& config) {
+  BQ4050_BUS_SCOPE();
   uint8_t ioReg = 0;
 
   if (config.btpEnable) ioReg |= 0x01;
@@ -1262,9 +3617,14 @@ bool BQ4050::setIOConfig(const IOConfig& config) {
 }
 
 TemperatureConfig BQ4050::getTemperatureConfig() {
+  BQ4050_BUS_SCOPE();
+  uint8_t data[2] = {0};
+  readDataFlashBlock(0x4004, data, sizeof(data)); // Temperature Configuration registers 1 and 2
+  return decodeTemperatureConfig(data[0], data[1]);
+}
+
+TemperatureConfig BQ4050::decodeTemperatureConfig(uint8_t tempReg1, uint8_t tempReg2) {
   TemperatureConfig config;
-  uint8_t tempReg1 = readDataFlash(0x4004); // Temperature Configuration register 1
-  uint8_t tempReg2 = readDataFlash(0x4005); // Temperature Configuration register 2
 
   config.ts1Enable = (tempReg1 & 0x01) != 0;
   config.ts2Enable = (tempReg1 & 0x02) != 0;
@@ -1282,6 +3642,7 @@ TemperatureConfig BQ4050::getTemperatureConfig() {
 }
 
 bool BQ4050::setTemperatureConfig(const TemperatureConfig& config) {
+  BQ4050_BUS_SCOPE();
   uint8_t tempReg1 = 0;
   uint8_t tempReg2 = 0;
 
@@ -1297,18 +3658,23 @@ bool BQ4050::setTemperatureConfig(const TemperatureConfig& config) {
   if (config.ts4CellMode) tempReg2 |= 0x08;
   if (config.internalCellMode) tempReg2 |= 0x10;
 
-  bool success = writeDataFlash(0x4004, tempReg1);
-  success &= writeDataFlash(0x4005, tempReg2);
-
-  return success;
+  uint8_t data[2] = {tempReg1, tempReg2};
+  return writeDataFlashBlock(0x4004, data, sizeof(data));
 }
 
 LEDConfig BQ4050::getLEDConfig() {
+  BQ4050_BUS_SCOPE();
+  uint8_t data[3] = {0};
+  readDataFlashBlock(0x4006, data, sizeof(data)); // Display mask (0x4006-0x4007) and LED control (0x4008)
+  return decodeLEDConfig(data);
+}
+
+LEDConfig BQ4050::decodeLEDConfig(const uint8_t* data) {
   LEDConfig config;
 
-  config.displayMask = readDataFlash(0x4006) | (readDataFlash(0x4007) << 8);
+  config.displayMask = data[0] | (data[1] << 8);
 
-  uint8_t ledCtrl = readDataFlash(0x4008);
+  uint8_t ledCtrl = data[2];
   config.ledEnable = (ledCtrl & 0x01) != 0;
   config.blinkRate = (ledCtrl >> 1) & 0x07;
   config.flashRate = (ledCtrl >> 4) & 0x0F;
@@ -1317,7 +3683,9 @@ LEDConfig BQ4050::getLEDConfig() {
 }
 
 bool BQ4050::setLEDConfig(const LEDConfig& config) {
+  BQ4050_BUS_SCOPE();
   bool success = true;
+  beginDataFlashBatch();
 
   success &= writeDataFlash(0x4006, config.displayMask & 0xFF);
   success &= writeDataFlash(0x4007, (config.displayMask >> 8) & 0xFF);
@@ -1329,23 +3697,33 @@ bool BQ4050::setLEDConfig(const LEDConfig& config) {
 
   success &= writeDataFlash(0x4008, ledCtrl);
 
+  success &= commitDataFlashBatch();
   return success;
 }
 
 BalancingConfig BQ4050::getBalancingConfig() {
+  BQ4050_BUS_SCOPE();
+  uint8_t data[5] = {0};
+  readDataFlashBlock(0x4009, data, sizeof(data)); // Balance control, voltage and time (0x4009-0x400D)
+  return decodeBalancingConfig(data);
+}
+
+BalancingConfig BQ4050::decodeBalancingConfig(const uint8_t* data) {
   BalancingConfig config;
 
-  uint8_t balanceCtrl = readDataFlash(0x4009);
+  uint8_t balanceCtrl = data[0];
   config.cellBalancingEnable = (balanceCtrl & 0x01) != 0;
 
-  config.balanceVoltage = readDataFlash(0x400A) | (readDataFlash(0x400B) << 8);
-  config.balanceTime = readDataFlash(0x400C) | (readDataFlash(0x400D) << 8);
+  config.balanceVoltage = data[1] | (data[2] << 8);
+  config.balanceTime = data[3] | (data[4] << 8);
 
   return config;
 }
 
 bool BQ4050::setBalancingConfig(const BalancingConfig& config) {
+  BQ4050_BUS_SCOPE();
   bool success = true;
+  beginDataFlashBatch();
 
   uint8_t balanceCtrl = 0;
   if (config.cellBalancingEnable) balanceCtrl |= 0x01;
@@ -1356,12 +3734,17 @@ bool BQ4050::setBalancingConfig(const BalancingConfig& config) {
   success &= writeDataFlash(0x400C, config.balanceTime & 0xFF);
   success &= writeDataFlash(0x400D, (config.balanceTime >> 8) & 0xFF);
 
+  success &= commitDataFlashBatch();
   return success;
 }
 
 SBSGaugingConfig BQ4050::getSBSGaugingConfig() {
+  BQ4050_BUS_SCOPE();
+  return decodeSBSGaugingConfig(readDataFlash(0x400E));
+}
+
+SBSGaugingConfig BQ4050::decodeSBSGaugingConfig(uint8_t gaugingReg) {
   SBSGaugingConfig config;
-  uint8_t gaugingReg = readDataFlash(0x400E);
 
   config.rsocHold = (gaugingReg & 0x01) != 0;
   config.capacitySync = (gaugingReg & 0x02) != 0;
@@ -1371,6 +3754,7 @@ SBSGaugingConfig BQ4050::getSBSGaugingConfig() {
 }
 
 bool BQ4050::setSBSGaugingConfig(const SBSGaugingConfig& config) {
+  BQ4050_BUS_SCOPE();
   uint8_t gaugingReg = 0;
 
   if (config.rsocHold) gaugingReg |= 0x01;
@@ -1381,8 +3765,12 @@ bool BQ4050::setSBSGaugingConfig(const SBSGaugingConfig& config) {
 }
 
 SBSConfig BQ4050::getSBSConfig() {
+  BQ4050_BUS_SCOPE();
+  return decodeSBSConfig(readDataFlash(0x400F));
+}
+
+SBSConfig BQ4050::decodeSBSConfig(uint8_t sbsReg) {
   SBSConfig config;
-  uint8_t sbsReg = readDataFlash(0x400F);
 
   config.specificationMode = (sbsReg & 0x01) != 0;
   config.packetErrorCheck = (sbsReg & 0x02) != 0;
@@ -1392,6 +3780,7 @@ SBSConfig BQ4050::getSBSConfig() {
 }
 
 bool BQ4050::setSBSConfig(const SBSConfig& config) {
+  BQ4050_BUS_SCOPE();
   uint8_t sbsReg = 0;
 
   if (config.specificationMode) sbsReg |= 0x01;
@@ -1402,8 +3791,12 @@ bool BQ4050::setSBSConfig(const SBSConfig& config) {
 }
 
 SOCFlagConfig BQ4050::getSOCFlagConfig() {
+  BQ4050_BUS_SCOPE();
+  return decodeSOCFlagConfig(readDataFlash(0x4010));
+}
+
+SOCFlagConfig BQ4050::decodeSOCFlagConfig(uint8_t socReg) {
   SOCFlagConfig config;
-  uint8_t socReg = readDataFlash(0x4010);
 
   config.tcSetOnCharge = (socReg & 0x01) != 0;
   config.fcSetOnCharge = (socReg & 0x02) != 0;
@@ -1415,6 +3808,7 @@ SOCFlagConfig BQ4050::getSOCFlagConfig() {
 }
 
 bool BQ4050::setSOCFlagConfig(const SOCFlagConfig& config) {
+  BQ4050_BUS_SCOPE();
   uint8_t socReg = 0;
 
   if (config.tcSetOnCharge) socReg |= 0x01;
@@ -1427,8 +3821,12 @@ bool BQ4050::setSOCFlagConfig(const SOCFlagConfig& config) {
 }
 
 ProtectionConfig BQ4050::getProtectionConfig() {
+  BQ4050_BUS_SCOPE();
+  return decodeProtectionConfig(readDataFlash(0x4011));
+}
+
+ProtectionConfig BQ4050::decodeProtectionConfig(uint8_t protReg) {
   ProtectionConfig config;
-  uint8_t protReg = readDataFlash(0x4011);
 
   config.protectionEnable = (protReg & 0x01) != 0;
   config.protectionDelay = (protReg >> 1) & 0x7F;
@@ -1437,6 +3835,7 @@ ProtectionConfig BQ4050::getProtectionConfig() {
 }
 
 bool BQ4050::setProtectionConfig(const ProtectionConfig& config) {
+  BQ4050_BUS_SCOPE();
   uint8_t protReg = 0;
 
   if (config.protectionEnable) protReg |= 0x01;
@@ -1447,6 +3846,7 @@ bool BQ4050::setProtectionConfig(const ProtectionConfig& config) {
 
 // Quick Setup Methods
 bool BQ4050::configureFor1S(bool balancing) {
+  BQ4050_BUS_SCOPE();
   DAConfiguration daConfig = getDAConfiguration();
   daConfig.cellCount = ONE_CELL;
 
@@ -1460,6 +3860,7 @@ bool BQ4050::configureFor1S(bool balancing) {
 }
 
 bool BQ4050::configureFor2S(bool balancing) {
+  BQ4050_BUS_SCOPE();
   DAConfiguration daConfig = getDAConfiguration();
   daConfig.cellCount = TWO_CELL;
 
@@ -1473,6 +3874,7 @@ bool BQ4050::configureFor2S(bool balancing) {
 }
 
 bool BQ4050::configureFor3S(bool balancing) {
+  BQ4050_BUS_SCOPE();
   DAConfiguration daConfig = getDAConfiguration();
   daConfig.cellCount = THREE_CELL;
 
@@ -1486,6 +3888,7 @@ bool BQ4050::configureFor3S(bool balancing) {
 }
 
 bool BQ4050::configureFor4S(bool balancing) {
+  BQ4050_BUS_SCOPE();
   DAConfiguration daConfig = getDAConfiguration();
   daConfig.cellCount = FOUR_CELL;
 
@@ -1499,6 +3902,7 @@ bool BQ4050::configureFor4S(bool balancing) {
 }
 
 bool BQ4050::configureForRemovableBattery() {
+  BQ4050_BUS_SCOPE();
   DAConfiguration daConfig = getDAConfiguration();
   daConfig.nonRemovable = false;
   daConfig.inSystemSleep = false;
@@ -1507,6 +3911,7 @@ bool BQ4050::configureForRemovableBattery() {
 }
 
 bool BQ4050::configureForEmbeddedBattery() {
+  BQ4050_BUS_SCOPE();
   DAConfiguration daConfig = getDAConfiguration();
   daConfig.nonRemovable = true;
   daConfig.inSystemSleep = true;
@@ -1515,6 +3920,7 @@ bool BQ4050::configureForEmbeddedBattery() {
 }
 
 bool BQ4050::configureForPortableDevice() {
+  BQ4050_BUS_SCOPE();
   PowerConfig powerConfig = getPowerConfig();
   powerConfig.autoShipEnable = true;
 
@@ -1528,6 +3934,7 @@ bool BQ4050::configureForPortableDevice() {
 }
 
 bool BQ4050::configureForPowerBank() {
+  BQ4050_BUS_SCOPE();
   LEDConfig ledConfig = getLEDConfig();
   ledConfig.ledEnable = true;
 
@@ -1542,6 +3949,7 @@ bool BQ4050::configureForPowerBank() {
 
 // Configuration Management
 bool BQ4050::validateConfiguration() {
+  BQ4050_BUS_SCOPE();
   // Basic validation checks
   CellCount cellCount = getCellCount();
   if (cellCount > FOUR_CELL) return false;
@@ -1558,10 +3966,12 @@ bool BQ4050::validateConfiguration() {
 }
 
 bool BQ4050::isConfigurationValid() {
+  BQ4050_BUS_SCOPE();
   return validateConfiguration();
 }
 
 String BQ4050::getConfigurationErrors() {
+  BQ4050_BUS_SCOPE();
   String errors = "";
 
   CellCount cellCount = getCellCount();
@@ -1580,25 +3990,32 @@ String BQ4050::getConfigurationErrors() {
 }
 
 FullConfiguration BQ4050::backupConfiguration() {
+  BQ4050_BUS_SCOPE();
   FullConfiguration config;
-
-  config.daConfig = getDAConfiguration();
-  config.fetOptions = getFETOptions();
-  config.powerConfig = getPowerConfig();
-  config.ioConfig = getIOConfig();
-  config.tempConfig = getTemperatureConfig();
-  config.ledConfig = getLEDConfig();
-  config.balanceConfig = getBalancingConfig();
-  config.sbsGauging = getSBSGaugingConfig();
-  config.sbsConfig = getSBSConfig();
-  config.socFlags = getSOCFlagConfig();
-  config.protection = getProtectionConfig();
+  uint8_t data[18] = {0};
+
+  // All settings registers live in 0x4000-0x4011, so one block read covers them
+  readDataFlashBlock(0x4000, data, sizeof(data));
+
+  config.daConfig = decodeDAConfiguration(data[0x00]);
+  config.fetOptions = decodeFETOptions(data[0x01]);
+  config.powerConfig = decodePowerConfig(data[0x02]);
+  config.ioConfig = decodeIOConfig(data[0x03]);
+  config.tempConfig = decodeTemperatureConfig(data[0x04], data[0x05]);
+  config.ledConfig = decodeLEDConfig(&data[0x06]);
+  config.balanceConfig = decodeBalancingConfig(&data[0x09]);
+  config.sbsGauging = decodeSBSGaugingConfig(data[0x0E]);
+  config.sbsConfig = decodeSBSConfig(data[0x0F]);
+  config.socFlags = decodeSOCFlagConfig(data[0x10]);
+  config.protection = decodeProtectionConfig(data[0x11]);
 
   return config;
 }
 
 bool BQ4050::restoreConfiguration(const FullConfiguration& config) {
+  BQ4050_BUS_SCOPE();
   bool success = true;
+  beginDataFlashBatch();  // Settings registers are contiguous: one block write
 
   success &= setDAConfiguration(config.daConfig);
   success &= setFETOptions(config.fetOptions);
@@ -1612,10 +4029,12 @@ bool BQ4050::restoreConfiguration(const FullConfiguration& config) {
   success &= setSOCFlagConfig(config.socFlags);
   success &= setProtectionConfig(config.protection);
 
+  success &= commitDataFlashBatch();
   return success;
 }
 
 bool BQ4050::resetToFactoryDefaults() {
+  BQ4050_BUS_SCOPE();
   // Reset all configuration registers to factory defaults
   // This is a simplified implementation - actual factory defaults would vary
   DAConfiguration daConfig = {false, false, false, false, false, false, THREE_CELL};
@@ -1631,6 +4050,7 @@ bool BQ4050::resetToFactoryDefaults() {
   ProtectionConfig protection = {true, 5};
 
   bool success = true;
+  beginDataFlashBatch();  // Settings registers are contiguous: one block write
   success &= setDAConfiguration(daConfig);
   success &= setFETOptions(fetOptions);
   success &= setPowerConfig(powerConfig);
@@ -1643,55 +4063,44 @@ bool BQ4050::resetToFactoryDefaults() {
   success &= setSOCFlagConfig(socFlags);
   success &= setProtectionConfig(protection);
 
+  success &= commitDataFlashBatch();
   return success;
 }
 
 // Direct Register Access
 bool BQ4050::writeConfigRegister(uint16_t address, uint8_t value) {
+  BQ4050_BUS_SCOPE();
   return writeDataFlash(address, value);
 }
 
 uint8_t BQ4050::readConfigRegister(uint16_t address) {
+  BQ4050_BUS_SCOPE();
   return readDataFlash(address);
 }
 
 // Utility Methods
 
 uint8_t BQ4050::calculatePEC(const uint8_t* data, uint8_t length) {
-  // PEC calculation using CRC-8 with polynomial x^8 + x^2 + x^1 + 1
-  // SMBus uses CRC-8 for Packet Error Check
-  // Lookup table implementation for better performance (based on NMIoT implementation)
-  static const uint8_t crc8_lookup[256] = {
-    0x00, 0x07, 0x0E, 0x09, 0x1C, 0x1B, 0x12, 0x15, 0x38, 0x3F, 0x36, 0x31, 0x24, 0x23, 0x2A, 0x2D,
-    0x70, 0x77, 0x7E, 0x79, 0x6C, 0x6B, 0x62, 0x65, 0x48, 0x4F, 0x46, 0x41, 0x54, 0x53, 0x5A, 0x5D,
-    0xE0, 0xE7, 0xEE, 0xE9, 0xFC, 0xFB, 0xF2, 0xF5, 0xD8, 0xDF, 0xD6, 0xD1, 0xC4, 0xC3, 0xCA, 0xCD,
-    0x90, 0x97, 0x9E, 0x99, 0x8C, 0x8B, 0x82, 0x85, 0xA8, 0xAF, 0xA6, 0xA1, 0xB4, 0xB3, 0xBA, 0xBD,
-    0xC7, 0xC0, 0xC9, 0xCE, 0xDB, 0xDC, 0xD5, 0xD2, 0xFF, 0xF8, 0xF1, 0xF6, 0xE3, 0xE4, 0xED, 0xEA,
-    0xB7, 0xB0, 0xB9, 0xBE, 0xAB, 0xAC, 0xA5, 0xA2, 0x8F, 0x88, 0x81, 0x86, 0x93, 0x94, 0x9D, 0x9A,
-    0x27, 0x20, 0x29, 0x2E, 0x3B, 0x3C, 0x35, 0x32, 0x1F, 0x18, 0x11, 0x16, 0x03, 0x04, 0x0D, 0x0A,
-    0x57, 0x50, 0x59, 0x5E, 0x4B, 0x4C, 0x45, 0x42, 0x6F, 0x68, 0x61, 0x66, 0x73, 0x74, 0x7D, 0x7A,
-    0x89, 0x8E, 0x87, 0x80, 0x95, 0x92, 0x9B, 0x9C, 0xB1, 0xB6, 0xBF, 0xB8, 0xAD, 0xAA, 0xA3, 0xA4,
-    0xF9, 0xFE, 0xF7, 0xF0, 0xE5, 0xE2, 0xEB, 0xEC, 0xC1, 0xC6, 0xCF, 0xC8, 0xDD, 0xDA, 0xD3, 0xD4,
-    0x69, 0x6E, 0x67, 0x60, 0x75, 0x72, 0x7B, 0x7C, 0x51, 0x56, 0x5F, 0x58, 0x4D, 0x4A, 0x43, 0x44,
-    0x19, 0x1E, 0x17, 0x10, 0x05, 0x02, 0x0B, 0x0C, 0x21, 0x26, 0x2F, 0x28, 0x3D, 0x3A, 0x33, 0x34,
-    0x4E, 0x49, 0x40, 0x47, 0x52, 0x55, 0x5C, 0x5B, 0x76, 0x71, 0x78, 0x7F, 0x6A, 0x6D, 0x64, 0x63,
-    0x3E, 0x39, 0x30, 0x37, 0x22, 0x25, 0x2C, 0x2B, 0x06, 0x01, 0x08, 0x0F, 0x1A, 0x1D, 0x14, 0x13,
-    0xAE, 0xA9, 0xA0, 0xA7, 0xB2, 0xB5, 0xBC, 0xBB, 0x96, 0x91, 0x98, 0x9F, 0x8A, 0x8D, 0x84, 0x83,
-    0xDE, 0xD9, 0xD0, 0xD7, 0xC2, 0xC5, 0xCC, 0xCB, 0xE6, 0xE1, 0xE8, 0xEF, 0xFA, 0xFD, 0xF4, 0xF3
-  };
-
   uint8_t crc = 0x00;
   for (uint8_t i = 0; i < length; i++) {
-    crc = crc8_lookup[crc ^ data[i]];
+    crc = crc8Update(crc, data[i]);
   }
-
   return crc;
 }
 
-bool BQ4050::validatePEC(const uint8_t* data, uint8_t length, uint8_t expectedPEC) {
-  uint8_t calculatedPEC = calculatePEC(data, length);
-  if (calculatedPEC != expectedPEC) {
+uint8_t BQ4050::pecReadPrefix(uint8_t command) const {
+  // Address write byte is folded in once at construction; command and address
+  // read byte cost two lookups
+  return crc8Update(crc8Update(_pecAddressCRC, command), (uint8_t)((_address << 1) | 1));
+}
+
+bool BQ4050::checkPEC(uint8_t crc, const uint8_t* data, uint8_t length, uint8_t receivedPEC) {
+  for (uint8_t i = 0; i < length; i++) {
+    crc = crc8Update(crc, data[i]);
+  }
+  if (crc != receivedPEC) {
     setError(BQ4050_ERROR_PEC_MISMATCH);
+    trackBusHealth(false);  // Corrupted frames count against the current bus rate
     return false;
   }
   return true;
@@ -3,6 +3,7 @@
 
 #include <Arduino.h>
 #include <Wire.h>
+#include "BQ4050Transport.h"
 
 // Optional utilities inclusion
 // Define BQ4050_INCLUDE_UTILS to include utility functions for human-readable output
@@ -33,6 +34,14 @@
   #define BQ4050_DEBUG_BEGIN()
 #endif
 
+// Bus accounting - define BQ4050_BUS_STATS to count transactions, bytes and
+// wait time, attributed to the public method that caused them
+#ifdef BQ4050_BUS_STATS
+  #define BQ4050_BUS_SCOPE() BusScope _busScope(this, __func__)
+#else
+  #define BQ4050_BUS_SCOPE()
+#endif
+
 // Regular SBS Command Register Addresses (Standard Smart Battery System commands)
 #define BQ4050_CMD_REMAINING_CAPACITY_ALARM     0x01
 #define BQ4050_CMD_REMAINING_TIME_ALARM         0x02
@@ -59,6 +68,7 @@
 #define BQ4050_CMD_CELL_VOLTAGE_3               0x3D
 #define BQ4050_CMD_CELL_VOLTAGE_2               0x3E
 #define BQ4050_CMD_CELL_VOLTAGE_1               0x3F
+#define BQ4050_CMD_MANUFACTURER_BLOCK_ACCESS    0x44
 #define BQ4050_CMD_SAFETY_ALERT                 0x50
 #define BQ4050_CMD_SAFETY_STATUS                0x51
 #define BQ4050_CMD_PF_ALERT                     0x52
@@ -136,6 +146,73 @@
 #define BQ4050_MAC_EXIT_CALIBRATION_OUTPUT      0xF080  // ExitCalibrationOutput - Read/Write (unsealed only)
 #define BQ4050_MAC_OUTPUT_CC_ADC_CALIBRATION    0xF081  // OutputCCandADCforCalibration - Read/Write (unsealed only)
 
+// Default security keys (first word, second word) as shipped by TI
+#define BQ4050_DEFAULT_UNSEAL_KEY_1             0x0414
+#define BQ4050_DEFAULT_UNSEAL_KEY_2             0x3672
+#define BQ4050_DEFAULT_FULL_ACCESS_KEY_1        0xFFFF
+#define BQ4050_DEFAULT_FULL_ACCESS_KEY_2        0xFFFF
+
+// Data flash write-combining batch capacity (staged bytes). Override with
+// -DBQ4050_DF_BATCH_SIZE=N; a full batch is flushed automatically.
+#ifndef BQ4050_DF_BATCH_SIZE
+  #if defined(__AVR__)
+    #define BQ4050_DF_BATCH_SIZE 24
+  #else
+    #define BQ4050_DF_BATCH_SIZE 48
+  #endif
+#endif
+
+// Data flash shadow cache capacity in 32-byte rows (optional, off until enabled).
+// Override with -DBQ4050_DF_CACHE_ROWS=N.
+#ifndef BQ4050_DF_CACHE_ROWS
+  #if defined(__AVR__)
+    #define BQ4050_DF_CACHE_ROWS 2
+  #else
+    #define BQ4050_DF_CACHE_ROWS 8
+  #endif
+#endif
+
+// Number of public methods tracked individually by the bus accounting.
+// Override with -DBQ4050_BUS_STATS_METHODS=N.
+#ifndef BQ4050_BUS_STATS_METHODS
+  #ifdef __AVR__
+    #define BQ4050_BUS_STATS_METHODS 8
+  #else
+    #define BQ4050_BUS_STATS_METHODS 24
+  #endif
+#endif
+
+// Per-command latency histograms - define BQ4050_LATENCY_STATS to enable.
+// Fixed table of BQ4050_LATENCY_SLOTS histograms, one per SBS command or MAC
+// subcommand seen; override the slot count with -DBQ4050_LATENCY_SLOTS=N.
+#ifndef BQ4050_LATENCY_SLOTS
+  #ifdef __AVR__
+    #define BQ4050_LATENCY_SLOTS 4
+  #else
+    #define BQ4050_LATENCY_SLOTS 32
+  #endif
+#endif
+
+// Capacity of the sentinel rule table (word results that mean "read again").
+// Override with -DBQ4050_SENTINEL_RULES=N.
+#ifndef BQ4050_SENTINEL_RULES
+  #ifdef __AVR__
+    #define BQ4050_SENTINEL_RULES 6
+  #else
+    #define BQ4050_SENTINEL_RULES 16
+  #endif
+#endif
+
+// Register shadow capacity for the background poller (SBS word registers).
+// Override with -DBQ4050_SHADOW_REGISTERS=N.
+#ifndef BQ4050_SHADOW_REGISTERS
+  #ifdef __AVR__
+    #define BQ4050_SHADOW_REGISTERS 6
+  #else
+    #define BQ4050_SHADOW_REGISTERS 24
+  #endif
+#endif
+
 // Data Flash Address Range
 #define BQ4050_DATA_FLASH_START                 0x4000
 #define BQ4050_DATA_FLASH_END                   0x5FFF
@@ -148,7 +225,9 @@ enum BQ4050_Error {
   BQ4050_ERROR_INVALID_PARAMETER,
   BQ4050_ERROR_CRC_MISMATCH,
   BQ4050_ERROR_PEC_MISMATCH,
-  BQ4050_ERROR_DEVICE_NOT_FOUND
+  BQ4050_ERROR_DEVICE_NOT_FOUND,
+  BQ4050_ERROR_UNEXPECTED_RESPONSE,
+  BQ4050_ERROR_ACCESS_DENIED           // Needs a higher security mode than the gauge is in
 };
 
 // Security modes
@@ -159,6 +238,27 @@ enum BQ4050_SecurityMode {
   BQ4050_SECURITY_UNKNOWN = 3
 };
 
+// Manufacturer Access transaction state (split-phase MAC reads)
+enum BQ4050_MACState {
+  BQ4050_MAC_STATE_IDLE = 0,     // No MAC command outstanding
+  BQ4050_MAC_STATE_PENDING = 1,  // Command written, gauge still processing
+  BQ4050_MAC_STATE_READY = 2,    // Processing window elapsed, result can be collected
+  BQ4050_MAC_STATE_ERROR = 3     // Command write failed
+};
+
+// Failure classes a RetryPolicy may retry (bitmask)
+enum BQ4050_RetryOn {
+  RETRY_ON_ADDRESS_NACK = 0x01,  // Gauge busy or absent; nothing was delivered
+  RETRY_ON_DATA_NACK    = 0x02,  // Command byte rejected, usually a security restriction
+  RETRY_ON_BUS_ERROR    = 0x04,  // Arbitration loss or other bus error
+  RETRY_ON_TIMEOUT      = 0x08,  // Bus timeout, or fewer bytes than requested
+  RETRY_ON_PEC_ERROR    = 0x10,
+  RETRY_ON_SENTINEL     = 0x20,  // Word result matched a sentinel rule
+
+  RETRY_ON_TRANSIENT = RETRY_ON_ADDRESS_NACK | RETRY_ON_BUS_ERROR | RETRY_ON_TIMEOUT |
+                       RETRY_ON_PEC_ERROR | RETRY_ON_SENTINEL
+};
+
 // Cell count enumeration
 enum CellCount {
   ONE_CELL = 0,
@@ -180,6 +280,27 @@ struct TemperatureStatus {
   float fetTemp;
 };
 
+// DAStatus1 (0x71): one time-coherent sample of the analog front end
+struct DAStatus1 {
+  float cellVoltage[4];         // Cell 1-4 voltages (V)
+  float batVoltage;             // BAT pin voltage (V)
+  float packVoltage;            // PACK pin voltage (V)
+  float cellCurrent[4];         // Cell 1-4 currents simultaneous with the voltages (A)
+  float cellPower[4];           // Cell 1-4 powers (W)
+  float power;                  // Sum of cell powers (W)
+  float averagePower;           // Average of power over the gauge update window (W)
+  uint8_t length;               // Payload bytes decoded; fields past it read 0
+};
+
+// DAStatus2 (0x72): every temperature sensor from one sample
+struct DAStatus2 {
+  float internal;               // Internal temperature sensor (C)
+  float ts1, ts2, ts3, ts4;     // External thermistors (C)
+  float cellTemp;               // Cell temperature used for protections (C)
+  float fetTemp;                // FET temperature (C)
+  uint8_t length;               // Payload bytes decoded; fields past it read 0
+};
+
 struct BatteryInfo {
   float voltage, current, temperature;
   int soc, cycleCount;
@@ -345,16 +466,263 @@ struct FullConfiguration {
   ProtectionConfig protection;
 };
 
+// Snapshot fields for readSnapshot(). OR them together to build a field mask;
+// the library plans the smallest set of bus reads that covers the request.
+enum BQ4050_SnapshotField {
+  SNAPSHOT_VOLTAGE                = 0x00000001,  // Voltage() 0x09
+  SNAPSHOT_CURRENT                = 0x00000002,  // Current() 0x0A
+  SNAPSHOT_AVERAGE_CURRENT        = 0x00000004,  // AverageCurrent() 0x0B
+  SNAPSHOT_TEMPERATURE            = 0x00000008,  // Temperature() 0x08
+  SNAPSHOT_RELATIVE_SOC           = 0x00000010,  // RelativeStateOfCharge() 0x0D
+  SNAPSHOT_ABSOLUTE_SOC           = 0x00000020,  // AbsoluteStateOfCharge() 0x0E
+  SNAPSHOT_REMAINING_CAPACITY     = 0x00000040,  // RemainingCapacity() 0x0F
+  SNAPSHOT_FULL_CHARGE_CAPACITY   = 0x00000080,  // FullChargeCapacity() 0x10
+  SNAPSHOT_RUN_TIME_TO_EMPTY      = 0x00000100,  // RunTimeToEmpty() 0x11
+  SNAPSHOT_AVERAGE_TIME_TO_FULL   = 0x00000200,  // AverageTimeToFull() 0x13
+  SNAPSHOT_BATTERY_STATUS         = 0x00000400,  // BatteryStatus() 0x16 (also fills charging/discharging)
+  SNAPSHOT_CYCLE_COUNT            = 0x00000800,  // CycleCount() 0x17
+  SNAPSHOT_SAFETY_STATUS          = 0x00001000,  // SafetyStatus() 0x51
+  SNAPSHOT_CELL_VOLTAGES          = 0x00002000,  // Cell voltages 1-4 (DAStatus1)
+  SNAPSHOT_PACK_VOLTAGE           = 0x00004000,  // PACK pin voltage (DAStatus1)
+  SNAPSHOT_BAT_VOLTAGE            = 0x00008000,  // BAT pin voltage (DAStatus1)
+
+  SNAPSHOT_BASIC = SNAPSHOT_VOLTAGE | SNAPSHOT_CURRENT | SNAPSHOT_TEMPERATURE | SNAPSHOT_RELATIVE_SOC,
+  SNAPSHOT_ALL   = 0x0000FFFF
+};
+
+struct BatterySnapshot {
+  uint32_t fields;              // Fields actually captured (subset of the request on errors)
+  uint8_t transactions;         // Transport transfers it took, MAC writes and retries included
+  float voltage, current, averageCurrent, temperature;
+  uint8_t relativeSOC, absoluteSOC;
+  uint16_t remainingCapacity, fullChargeCapacity;
+  uint16_t runTimeToEmpty, averageTimeToFull;
+  uint16_t batteryStatus;
+  bool charging, discharging;
+  uint16_t cycleCount;
+  uint16_t safetyStatus;
+  float cellVoltage[4];
+  float packVoltage, batVoltage;
+};
+
+// Bus cost of one call, one method or the whole session
+struct BusStats {
+  uint32_t calls;               // Top-level public calls counted
+  uint32_t transactions;        // Transport transfers (write or write+read)
+  uint32_t bytesWritten;
+  uint32_t bytesRead;
+  uint32_t wireTimeUs;          // Time inside the transport
+  uint32_t delayTimeUs;         // Time spent waiting on the gauge (MAC processing)
+  uint32_t errors;              // Transfers that failed
+};
+
+struct BusMethodStats {
+  const char* method;           // Public method name (__func__)
+  BusStats stats;
+};
+
+// What a latency histogram is keyed on
+enum BQ4050_LatencyKind {
+  LATENCY_SBS = 0,              // Single SBS transfer, keyed by command byte
+  LATENCY_MAC = 1               // MAC subcommand, write through result read
+};
+
+// Log-bucketed latency histogram: two buckets per power of two from 1us up to
+// ~262ms (the last bucket is open ended). Percentiles are bucket upper bounds,
+// so they are accurate to within ~41%.
+struct LatencyHistogram {
+  static const uint8_t BUCKETS = 36;
+
+  uint8_t kind;                 // BQ4050_LatencyKind
+  uint16_t code;                // SBS command or MAC subcommand
+  uint32_t count;
+  uint32_t minUs, maxUs;
+  uint16_t buckets[BUCKETS];    // Saturating counts
+
+  void reset();
+  void record(uint32_t microseconds);
+  uint32_t percentile(uint8_t percent) const;
+
+  static uint8_t bucketFor(uint32_t microseconds);
+  static uint32_t bucketUpperBound(uint8_t bucket);
+};
+
+// Full-width (H4) copy of every protection and status register, 0x50-0x57
+struct StatusSnapshot {
+  uint32_t safetyAlert;
+  uint32_t safetyStatus;
+  uint32_t pfAlert;
+  uint32_t pfStatus;
+  uint32_t operationStatus;
+  uint32_t chargingStatus;
+  uint32_t gaugingStatus;
+  uint32_t manufacturingStatus;
+};
+
+// Settle times used by the driver. calibrateTiming() measures them; store the
+// struct anywhere (EEPROM, NVS, a file) and hand it back with setTimingProfile()
+// on the next boot to skip the measurement.
+struct TimingProfile {
+  static const uint8_t VERSION = 1;
+
+  uint8_t version;
+  uint16_t responseDelayUs;     // Write-to-read turnaround for byte and block reads
+  uint16_t macDelayUs;          // MAC command write to result available
+  uint8_t checksum;             // Guards against restoring blank or foreign storage
+
+  uint8_t computeChecksum() const;
+  bool isValid() const;
+};
+
+// Identity fields held by the cache (bitmask in IdentityInfo::fields)
+enum BQ4050_IdentityField {
+  IDENTITY_DEVICE_TYPE       = 0x0001,
+  IDENTITY_FIRMWARE_VERSION  = 0x0002,
+  IDENTITY_HARDWARE_VERSION  = 0x0004,
+  IDENTITY_DESIGN_CAPACITY   = 0x0008,
+  IDENTITY_DESIGN_VOLTAGE    = 0x0010,
+  IDENTITY_SERIAL_NUMBER     = 0x0020,
+  IDENTITY_MANUFACTURER_DATE = 0x0040,
+  IDENTITY_MANUFACTURER_NAME = 0x0080,
+  IDENTITY_DEVICE_NAME       = 0x0100,
+  IDENTITY_DEVICE_CHEMISTRY  = 0x0200,
+  IDENTITY_ALL               = 0x03FF
+};
+
+// Values that cannot change while the same pack is attached
+struct IdentityInfo {
+  uint16_t fields;              // BQ4050_IdentityField bits holding valid data
+  uint16_t deviceType, firmwareVersion, hardwareVersion;
+  uint16_t designCapacity, designVoltage;
+  uint16_t serialNumber, manufacturerDate;
+  String manufacturerName, deviceName, deviceChemistry;
+};
+
+// Retries applied inside every bus transaction. Backoff doubles per retry from
+// baseBackoffUs up to maxBackoffUs and is jittered over its upper half.
+struct RetryPolicy {
+  uint8_t maxAttempts;          // Tries per operation including the first; 1 disables retries
+  uint8_t retryOn;              // BQ4050_RetryOn mask
+  uint16_t baseBackoffUs;
+  uint16_t maxBackoffUs;
+  uint32_t budgetUs;            // No retry starts once this much time has passed since the first try
+};
+
+// A word result that signals a glitch rather than data (e.g. 0xFFFF from a
+// MAC read the gauge had not finished)
+struct SentinelRule {
+  bool mac;                     // MAC subcommand (true) or SBS command (false)
+  uint16_t code;
+  uint16_t value;
+};
+
+struct RetryStats {
+  uint32_t retries;             // Extra attempts made
+  uint32_t recovered;           // Operations that succeeded after at least one retry
+  uint32_t exhausted;           // Retryable failures left once attempts or budget ran out
+  uint32_t sentinels;           // Sentinel values received
+  uint32_t arbitrationLost;     // Bus errors, or a 0x44 echo showing another master's command
+};
+
+// Transaction schedule: MAC commands with plain SBS word and short block reads
+// interleaved into their processing windows. A combined poll then costs roughly
+// max(MAC latency, SBS reads) instead of their sum. Fill with add*() and
+// execute with BQ4050::runSchedule(); results are written back into the slots.
+struct TransactionSchedule {
+  static const uint8_t MAX_READS = 16;
+  static const uint8_t MAX_MAC_COMMANDS = 4;
+  static const uint8_t MAX_BLOCK_READS = 8;
+
+  struct Read {
+    uint8_t reg;
+    uint16_t value;
+    bool ok;
+  };
+
+  // SBS block of up to 4 bytes (H4 status registers), packed little endian
+  struct BlockRead {
+    uint8_t reg;
+    uint32_t value;
+    uint8_t length;
+    bool ok;
+  };
+
+  struct MACRead {
+    uint16_t command;
+    bool wide;        // true = 32-bit result, false = 16-bit
+    uint32_t value;
+    bool ok;
+  };
+
+  Read reads[MAX_READS];
+  uint8_t readCount;
+  BlockRead blockReads[MAX_BLOCK_READS];
+  uint8_t blockCount;
+  MACRead macReads[MAX_MAC_COMMANDS];
+  uint8_t macCount;
+
+  TransactionSchedule() : readCount(0), blockCount(0), macCount(0) {}
+
+  // Returns the slot index, or -1 when the schedule is full
+  int8_t addRead(uint8_t reg) {
+    if (readCount >= MAX_READS) return -1;
+    reads[readCount].reg = reg;
+    reads[readCount].value = 0;
+    reads[readCount].ok = false;
+    return readCount++;
+  }
+
+  int8_t addBlockRead(uint8_t reg) {
+    if (blockCount >= MAX_BLOCK_READS) return -1;
+    blockReads[blockCount].reg = reg;
+    blockReads[blockCount].value = 0;
+    blockReads[blockCount].length = 0;
+    blockReads[blockCount].ok = false;
+    return blockCount++;
+  }
+
+  int8_t addManufacturerAccess(uint16_t command, bool wide = false) {
+    if (macCount >= MAX_MAC_COMMANDS) return -1;
+    macReads[macCount].command = command;
+    macReads[macCount].wide = wide;
+    macReads[macCount].value = 0;
+    macReads[macCount].ok = false;
+    return macCount++;
+  }
+
+  void clear() {
+    readCount = 0;
+    blockCount = 0;
+    macCount = 0;
+  }
+};
+
 class BQ4050 {
 public:
   explicit BQ4050(uint8_t address = 0x0B, TwoWire& wire = Wire);
+  explicit BQ4050(BQ4050Transport& transport, uint8_t address = 0x0B);
   
   // Flexible initialization methods
   bool begin();                                          // Use default I2C
   bool begin(TwoWire& wire);                            // Specify I2C interface
+  bool begin(BQ4050Transport& transport);               // Custom transport (e.g. Linux i2c-dev)
   bool begin(int sda, int scl);                         // Specify I2C pins (ESP32 style)
   bool begin(int sda, int scl, uint32_t frequency);     // Specify pins and frequency
 
+  // Response and MAC settle times (defaults 250 us / 5 ms)
+  bool calibrateTiming();                               // Measure on the attached gauge
+  void setCalibrateOnBegin(bool enable);                // Run calibrateTiming() from begin()
+  TimingProfile getTimingProfile() const;
+  bool setTimingProfile(const TimingProfile& profile);  // Rejects invalid or out-of-range profiles
+  void resetTimingProfile();                            // Back to the conservative defaults
+
+  // Bus speed negotiation: OperationStatus[XL] sets the ceiling (100 kHz, or
+  // 400 kHz in XL mode), then the clock steps up from 50 kHz while PEC-checked reads
+  // pass. A maxFrequency below 50 kHz is rejected without touching the clock.
+  uint32_t autotuneBusSpeed(uint32_t maxFrequency = 400000);  // Chosen clock, 0 on failure
+  void setBusSpeedFallback(bool enable);                // Step down a rate when errors pile up
+  uint32_t getBusFrequency() const;                     // 0 until set by begin() or autotune
+
   // Basic SBS Commands
   uint16_t getRemainingCapacityAlarm();
   uint16_t getRemainingTimeAlarm();
@@ -390,6 +758,7 @@ public:
   uint16_t getChargingStatus();
   uint16_t getGaugingStatus();
   uint16_t getManufacturingStatus();
+  StatusSnapshot getStatusSnapshot();
   
   // Extended SBS Commands
   uint16_t getAFERegister();
@@ -400,7 +769,9 @@ public:
   uint32_t getLifeTimeDataBlock5();
   String getManufacturerInfo();
   String getDAStatus1();
+  DAStatus1 getDAStatus1Data();
   String getDAStatus2();
+  DAStatus2 getDAStatus2Data();
   
 
   // Manufacturer Access Commands (basic 16-bit reads)
@@ -422,6 +793,22 @@ public:
   uint32_t getLifetimeDataBlock2();
   uint32_t getLifetimeDataBlock3();
 
+  // Non-blocking Manufacturer Access (start -> poll -> complete)
+  // startManufacturerAccess() writes the command and returns immediately. Poll until
+  // the state is READY, then collect the result. complete*() waits out any remaining
+  // processing time itself, so calling it early is safe but blocks.
+  bool startManufacturerAccess(uint16_t command);
+  BQ4050_MACState pollManufacturerAccess();
+  bool isManufacturerAccessReady();
+  uint16_t getPendingManufacturerAccess() const;
+  uint16_t completeManufacturerAccess16();
+  uint32_t completeManufacturerAccess32();
+  String completeManufacturerAccessBlock();
+  void cancelManufacturerAccess();
+
+  // Pipelined transactions (SBS reads run inside MAC processing windows)
+  bool runSchedule(TransactionSchedule& schedule);
+
   // FET Control
   bool enableChargeFET();
   bool disableChargeFET();
@@ -438,16 +825,52 @@ public:
   bool enterSleepMode();
   bool enterShutdownMode();
   
-  // Security Mode Detection
+  // Security Mode: OperationStatus[SEC1,SEC0], cached after the first read and kept
+  // current by every OperationStatus the driver sees. Seal, unseal and reset drop it.
+  // While the mode is known, status reads take the path that mode allows and reads
+  // needing more access fail with BQ4050_ERROR_ACCESS_DENIED without bus traffic.
   BQ4050_SecurityMode getSecurityMode();
+  BQ4050_SecurityMode refreshSecurityMode();            // Always reads the gauge
+  void invalidateSecurityMode();
   String getSecurityModeString();
   bool isSealed();
   bool isUnsealed();
   bool hasFullAccess();
+  bool unsealDevice(uint16_t key1 = BQ4050_DEFAULT_UNSEAL_KEY_1, uint16_t key2 = BQ4050_DEFAULT_UNSEAL_KEY_2);
+  bool enterFullAccess(uint16_t key1 = BQ4050_DEFAULT_FULL_ACCESS_KEY_1,
+                       uint16_t key2 = BQ4050_DEFAULT_FULL_ACCESS_KEY_2);
 
   // Data Flash Access
   uint8_t readDataFlash(uint16_t address);
   bool writeDataFlash(uint16_t address, uint8_t data);
+  bool readDataFlashBlock(uint16_t address, uint8_t* buffer, uint16_t length);  // Up to 32 bytes per transaction
+  bool writeDataFlashBlock(uint16_t address, const uint8_t* data, uint16_t length);
+
+  // Data flash write combining: writeDataFlash() calls between begin and commit are
+  // staged, merged into contiguous runs and flushed as one block write per run.
+  // Batches nest; only the outermost commit touches the bus. Runs a failed flush could
+  // not program stay staged, ahead of later writes, until commitDataFlashBatch() is
+  // called again and succeeds or discardDataFlashBatch() drops them.
+  void beginDataFlashBatch();
+  bool commitDataFlashBatch();
+  void discardDataFlashBatch();
+
+  // Data flash shadow cache: row-granular RAM copy of 0x4000-0x5FFF. While enabled,
+  // reads are served from RAM after the first fetch and writes only mark bytes dirty;
+  // commit() flushes the changed bytes. Reset and seal/unseal transitions commit pending
+  // changes, then invalidate it; they fail without touching the gauge if that commit fails.
+  // Invalidation only ever drops clean rows: dirty ones stay until commit() succeeds or
+  // discardDataFlashChanges() throws them away, and disabling the cache is refused
+  // while a commit fails.
+  void enableDataFlashCache(bool enable = true);
+  bool isDataFlashCacheEnabled() const;
+  bool hasUncommittedChanges() const;
+  bool commit();
+  void invalidateDataFlashCache();                      // Drops clean rows
+  void discardDataFlashChanges();                       // Drops every row, dirty ones included
+
+  // Field-mask snapshot (minimal transaction plan, one result struct)
+  BatterySnapshot readSnapshot(uint32_t fields);
 
   // Convenience Methods
   CellStatus getAllCellStatus();
@@ -534,35 +957,242 @@ public:
   bool writeConfigRegister(uint16_t address, uint8_t value);
   uint8_t readConfigRegister(uint16_t address);
 
+  // Retry policy
+  void setRetryPolicy(const RetryPolicy& policy);
+  RetryPolicy getRetryPolicy() const;
+  void resetRetryPolicy();                              // Default policy and sentinel rules
+  bool addSentinelRule(bool mac, uint16_t code, uint16_t value);
+  void clearSentinelRules();
+  const RetryStats& getRetryStats() const;
+  void resetRetryStats();
+
+  // Identity cache: DeviceType() through DeviceChemistry() are read once after
+  // begin() and served from RAM. Cleared by resetDevice(), when the gauge stops
+  // answering, and by validateIdentity() on an OperationStatus[INIT]/[PRES] or
+  // SerialNumber() change.
+  void setIdentityCacheEnabled(bool enable);
+  bool refreshIdentity();                               // Drop and re-read every field
+  bool validateIdentity();                              // SerialNumber + OperationStatus check; false if the cache was dropped
+  void invalidateIdentity();
+  const IdentityInfo& getIdentity() const;
+
+  // Background polling: registers added with pollRegister() are refreshed into
+  // a RAM shadow by tick(), each at its own period. Their getters answer from
+  // the shadow while it is younger than the entry's max age (default twice the
+  // period) and fall back to a bus read otherwise. SBS word registers only.
+  static const uint32_t SHADOW_AGE_NEVER = 0xFFFFFFFF;
+  bool pollRegister(uint8_t reg, uint32_t periodMs, uint32_t maxAgeMs = 0);
+  bool unpollRegister(uint8_t reg);
+  void clearPolling();
+  uint8_t tick();                                       // Refresh due registers; returns how many were read
+  uint32_t getNextPollDelay() const;                    // ms until an entry is due, SHADOW_AGE_NEVER if none
+  bool readShadow(uint8_t reg, uint16_t& value, uint32_t maxAgeMs);  // Bus read when older than maxAgeMs
+  uint32_t getShadowAge(uint8_t reg) const;             // ms since the last refresh, SHADOW_AGE_NEVER if none
+  void invalidateShadow();
+
+  // Shared-bus lock (held per transaction and from a MAC write until its result is read)
+  void setBusLock(BQ4050BusLock* lock, uint32_t timeoutMs = 100);
+  BQ4050BusLock* getBusLock() const;
+
+  // Stuck-bus recovery (Wire backend runs it automatically on timeouts with SDA low)
+  bool recoverBus();                                    // 9 SCL clocks + STOP, then re-init
+  const BusRecoveryStats& getBusRecoveryStats() const;
+
   // Error Handling
   BQ4050_Error getLastError() const;
+  uint8_t getLastTransportStatus() const;               // BQ4050_TRANSPORT_* of the last transaction
   static String getErrorString(BQ4050_Error error);
 
   // Debug Support
   void setPECEnabled(bool enable);
   bool isPECEnabled() const;
 
+#ifdef BQ4050_BUS_STATS
+  // Bus accounting
+  const BusStats& getBusStats() const;                  // Everything since the last reset
+  const BusStats& getLastCallStats() const;             // Most recent top-level public call
+  const char* getLastCallName() const;
+  uint8_t getMethodStatsCount() const;
+  BusMethodStats getMethodStats(uint8_t index) const;
+  BusStats getMethodStats(const char* method) const;    // Zeroed if the method was never seen
+  void resetBusStats();
+#endif
+
+#ifdef BQ4050_LATENCY_STATS
+  // Per-command latency histograms
+  const LatencyHistogram* getLatencyHistogram(BQ4050_LatencyKind kind, uint16_t code) const;
+  uint8_t getLatencyHistogramCount() const;
+  const LatencyHistogram* getLatencyHistogramAt(uint8_t index) const;
+  uint32_t getLatencyDroppedCount() const;              // Samples with no free slot
+  void resetLatencyHistograms();
+  void exportLatencyHistograms(Print& out) const;       // CSV: kind,code,count,min,p50,p90,p99,max
+#endif
+
 private:
   uint8_t _address;
-  TwoWire* _wire;
+  BQ4050WireTransport _wireTransport;
+  BQ4050Transport* _transport;
   BQ4050_Error _lastError;
   bool _pecEnabled;
+  uint8_t _pecAddressCRC;       // PEC state after the address write byte
+
+  // Outstanding Manufacturer Access command (split-phase MAC reads)
+  uint16_t _macCommand;
+  uint32_t _macStartUs;
+  BQ4050_MACState _macState;
+
+  // Per-instance settle times (see calibrateTiming())
+  uint16_t _responseDelayUs;
+  uint16_t _macDelayUs;
+  bool _calibrateOnBegin;
+
+  // Bus clock chosen by begin()/autotuneBusSpeed() and the fallback error window
+  uint32_t _busFrequency;
+  bool _busFallback;
+  uint8_t _busWindowCount;
+  uint8_t _busWindowErrors;
+
+  // Identity cache
+  IdentityInfo _identity;
+  bool _identityCacheEnabled;
+  uint32_t _identityOperationStatus;  // INIT/PRES as last seen, OPERATION_STATUS_UNKNOWN before that
+
+  // Shared-bus lock, taken once and counted for nested holders
+  class BusLockScope {
+  public:
+    explicit BusLockScope(BQ4050* owner) : _owner(owner), _held(owner->acquireBusLock()) {}
+    ~BusLockScope() { if (_held) _owner->releaseBusLock(); }
+    bool held() const { return _held; }
+  private:
+    BQ4050* _owner;
+    bool _held;
+  };
+  friend class BusLockScope;
+  BQ4050BusLock* _busLock;
+  uint32_t _busLockTimeoutMs;
+  uint8_t _busLockDepth;
+  bool _macLockHeld;  // Held from startManufacturerAccess() to complete/cancel
+
+  // Retry policy state
+  struct RetryState {
+    uint8_t attempt;
+    uint32_t startUs;
+  };
+  RetryPolicy _retryPolicy;
+  SentinelRule _sentinelRules[BQ4050_SENTINEL_RULES];
+  uint8_t _sentinelRuleCount;
+  RetryStats _retryStats;
+  uint32_t _retrySeed;
+  uint8_t _lastTransportStatus;
+  uint32_t _transferCount;             // Transport calls, retries included; always counted
+
+  // Staged data flash writes, kept sorted by address
+  struct DataFlashWrite {
+    uint16_t address;
+    uint8_t value;
+  };
+  DataFlashWrite _dfBatch[BQ4050_DF_BATCH_SIZE];
+  uint8_t _dfBatchCount;
+  uint8_t _dfBatchDepth;
+  uint32_t _dfProgramUs;        // micros() of the last data flash block write
+  bool _dfProgramPending;       // The gauge may still be programming it
+
+  // Polled register shadow; _shadowIndex maps an SBS word register to its slot
+  struct ShadowRegister {
+    uint8_t reg;
+    bool valid;
+    uint16_t value;
+    uint32_t periodMs;
+    uint32_t maxAgeMs;
+    uint32_t stampMs;   // millis() of the last successful read
+    uint32_t dueMs;     // millis() of the next tick() refresh
+  };
+  static const uint8_t SHADOW_WORD_REGISTERS = 0x40;
+  static const uint8_t NO_SHADOW = 0xFF;
+  ShadowRegister _shadow[BQ4050_SHADOW_REGISTERS];
+  uint8_t _shadowCount;
+  uint8_t _shadowIndex[SHADOW_WORD_REGISTERS];
+
+  // Data flash shadow cache rows (32-byte aligned)
+  struct DataFlashCacheRow {
+    uint16_t base;
+    bool valid;
+    uint32_t dirtyMask;  // One bit per byte in the row
+    uint8_t lastUse;
+    uint8_t data[32];
+  };
+  DataFlashCacheRow _dfCache[BQ4050_DF_CACHE_ROWS];
+  bool _dfCacheEnabled;
+  uint8_t _dfCacheClock;
+  BQ4050_SecurityMode _lastSecurityMode;  // Cached OperationStatus[SEC1,SEC0]
   
-  // Timing constants (microseconds)
-  static const uint16_t I2C_RESPONSE_DELAY_US = 250;   // Delay after I2C write before read
+#ifdef BQ4050_BUS_STATS
+  // Attributes I/O to the outermost public method on the call stack
+  class BusScope {
+  public:
+    BusScope(BQ4050* owner, const char* method);
+    ~BusScope();
+  private:
+    BQ4050* _owner;
+  };
+  friend class BusScope;
+
+  BusStats _busTotals;
+  BusStats _busCall;
+  BusStats _busLastCall;
+  const char* _busCallName;
+  const char* _busLastCallName;
+  uint8_t _busScopeDepth;
+  BusMethodStats _busMethods[BQ4050_BUS_STATS_METHODS];
+  uint8_t _busMethodCount;
+
+  void recordBusTransfer(uint8_t written, uint8_t read, uint32_t wireUs, bool ok);
+  void recordBusDelay(uint32_t delayUs);
+#endif
+
+#ifdef BQ4050_LATENCY_STATS
+  LatencyHistogram _latency[BQ4050_LATENCY_SLOTS];
+  uint8_t _latencyCount;
+  uint32_t _latencyDropped;
+
+  void recordLatency(BQ4050_LatencyKind kind, uint16_t code, uint32_t microseconds);
+#endif
+
+  // Timing defaults and calibration limits (microseconds)
+  static const uint16_t I2C_RESPONSE_DELAY_US = 250;   // Default delay after I2C write before read
+  static const uint16_t MAC_PROCESSING_DELAY_US = 5000; // Default gauge processing time after a MAC command write
+  static const uint16_t MAX_RESPONSE_DELAY_US = 5000;  // Largest accepted turnaround
+  static const uint16_t MIN_MAC_DELAY_US = 500;        // Smallest accepted MAC settle time
+  static const uint16_t MAX_MAC_DELAY_US = 50000;      // Calibration search ceiling
+  static const uint8_t CALIBRATION_TRIALS = 4;         // Consecutive passes required per candidate
+  static const uint8_t BUS_TUNE_READS = 8;             // PEC-checked reads per autotune step
+  static const uint8_t BUS_HEALTH_WINDOW = 32;         // Transactions per fallback error window
+  static const uint8_t BUS_HEALTH_MAX_ERRORS = 4;      // Failures in a window that trigger a step down
+  static const uint32_t OPERATION_STATUS_XL = 0x00400000;  // OperationStatus bit 22: 400-kHz SMBus mode
+  static const uint32_t OPERATION_STATUS_INIT = 0x01000000;  // Bit 24: gauge initialised after a full reset
+  static const uint32_t OPERATION_STATUS_PRES = 0x00000001;  // Bit 0: system present (PRES pin low)
+  static const uint32_t OPERATION_STATUS_UNKNOWN = 0xFFFFFFFF;
+  static const uint8_t OPERATION_STATUS_SEC_SHIFT = 8;      // Bits 9-8: 11 sealed, 10 unsealed, 01 full access
+  static const uint8_t SEALED_SBS_LIMIT = 0x4F;              // SBS 0x4F and up (except 0x70) need unsealed
   static const uint16_t I2C_TIMEOUT_MS = 100;          // I2C operation timeout
   static const uint8_t MAX_SBS_STRING_LENGTH = 32;     // Maximum SBS string length for buffer protection
+  static const uint8_t MAX_BLOCK_LENGTH = 34;          // 32-byte payload + 2-byte command/address echo on 0x44
+  static const uint8_t DATA_FLASH_BLOCK_SIZE = 32;     // Data flash bytes returned per ManufacturerBlockAccess read
 
   // I2C Communication Methods
   uint8_t readRegister8(uint8_t reg);
-  uint16_t readRegister16(uint8_t reg);
+  uint16_t readRegister16(uint8_t reg);                 // Served from the poller shadow when fresh
+  uint16_t fetchRegister16(uint8_t reg);                // Always on the bus
+  uint16_t refreshRegister16(uint8_t reg);              // On the bus, and updates the shadow
   uint32_t readRegister32(uint8_t reg);
   bool writeRegister8(uint8_t reg, uint8_t value);
   bool writeRegister16(uint8_t reg, uint16_t value);
+  bool writeBlock(uint8_t command, const uint8_t* data, uint8_t length);
   
   // Enhanced I2C helper methods
-  bool safeBeginTransmission(uint8_t reg);
-  uint8_t safeRequestData(uint8_t bytesToRead);
+  uint8_t readTransaction(uint8_t command, uint8_t* buffer, uint8_t length, bool exact,
+                          uint16_t turnaroundUs = 0);
+  bool writeTransaction(const uint8_t* data, uint8_t length);
   
   // Smart PEC management
   bool shouldUsePECForRegister(uint8_t reg) const;
@@ -574,16 +1204,89 @@ private:
   uint16_t manufacturerAccess16(uint16_t command);
   uint32_t manufacturerAccess32(uint16_t command);
   bool manufacturerAccessWrite(uint16_t command, uint16_t data);
+  uint8_t readMACBlock(uint16_t command, uint8_t* buffer, uint8_t length);  // 0x44 write, wait, echo-checked 0x44 read
+  void markManufacturerAccessPending(uint16_t command);
+  void endManufacturerAccess();
+  bool acquireBusLock();
+  void releaseBusLock();
+  void waitForManufacturerAccess();
+  void sleepMicroseconds(uint32_t microseconds);
+
+  // Retry policy
+  void beginRetry(RetryState& state);
+  bool shouldRetry(RetryState& state, uint8_t reason);
+  void endRetry(const RetryState& state);
+  bool matchesSentinel(bool mac, uint16_t code, uint16_t value);
+  static uint8_t retryReasonFor(uint8_t transportStatus);
+
+  // Background polling
+  ShadowRegister* findShadow(uint8_t reg);
+  void storeShadow(ShadowRegister& entry, uint16_t value);
+  void dropShadow(uint8_t reg);
+
+  // Security mode
+  bool writeSecurityKey(uint16_t key1, uint16_t key2, BQ4050_SecurityMode target);
+  bool requireAccess(BQ4050_SecurityMode level);
+  uint8_t readMirroredBlock(uint8_t command, uint8_t* buffer, uint8_t length);  // SBS block, or its MAC mirror when sealed
+  uint16_t readStatusRegister16(uint8_t reg);
+  static bool isSealedSBSCommand(uint8_t command);
+  static bool isSealedMACCommand(uint16_t command);
+  static BQ4050_SecurityMode securityModeFromOperationStatus(uint32_t operationStatus);
+
+  // Identity cache
+  void fillIdentity();
+  void observeOperationStatus(uint32_t operationStatus);
+
+  // Bus speed negotiation
+  bool readOperationStatus(uint32_t& value);
+  bool verifyBusSpeed();
+  void applyBusFrequency(uint32_t frequency);
+  void trackBusHealth(bool ok);
+
+  // Timing calibration
+  bool probeResponseDelay(uint16_t turnaroundUs, const uint8_t* reference, uint8_t length);
+  bool probeManufacturerAccess(uint16_t command, uint32_t waitUs);
+  bool calibrateResponseDelay(uint16_t& result);
+  bool calibrateMACDelay(uint16_t& result);
+
+  // Data flash write combining
+  bool fetchDataFlash(uint16_t address, uint8_t* buffer, uint16_t length);
+  bool programDataFlash(uint16_t address, const uint8_t* data, uint16_t length);
+  void waitForDataFlashProgram();
+  DataFlashCacheRow* getDataFlashCacheRow(uint16_t address);
+  bool flushDataFlashCacheRow(DataFlashCacheRow& row);
+  void clearDataFlashDirty(uint16_t address, uint8_t length);  // After a run has been programmed
+  bool releaseDataFlashCache();                                // Commit, then invalidate
+  bool stageDataFlashWrite(uint16_t address, uint8_t data);
+  bool flushDataFlashBatch();
 
   // Utility Methods
   static float convertTemperature(uint16_t rawTemp);
   static float convertVoltage(uint16_t rawVoltage);
   static float convertCurrent(int16_t rawCurrent);
   static uint8_t calculatePEC(const uint8_t* data, uint8_t length);
-  bool validatePEC(const uint8_t* data, uint8_t length, uint8_t expectedPEC);
+  uint8_t pecReadPrefix(uint8_t command) const;         // CRC of address+W, command, address+R
+  bool checkPEC(uint8_t crc, const uint8_t* data, uint8_t length, uint8_t receivedPEC);
   void setError(BQ4050_Error error);
   
+  // Settings flash decoders (shared by the individual getters and backupConfiguration)
+  static DAConfiguration decodeDAConfiguration(uint8_t daReg);
+  static FETOptions decodeFETOptions(uint8_t fetReg);
+  static PowerConfig decodePowerConfig(uint8_t powerReg);
+  static IOConfig decodeIOConfig(uint8_t ioReg);
+  static TemperatureConfig decodeTemperatureConfig(uint8_t tempReg1, uint8_t tempReg2);
+  static LEDConfig decodeLEDConfig(const uint8_t* data);
+  static BalancingConfig decodeBalancingConfig(const uint8_t* data);
+  static SBSGaugingConfig decodeSBSGaugingConfig(uint8_t gaugingReg);
+  static SBSConfig decodeSBSConfig(uint8_t sbsReg);
+  static SOCFlagConfig decodeSOCFlagConfig(uint8_t socReg);
+  static ProtectionConfig decodeProtectionConfig(uint8_t protReg);
+  static DAStatus1 decodeDAStatus1(const uint8_t* data, uint8_t length);
+  static DAStatus2 decodeDAStatus2(const uint8_t* data, uint8_t length);
+
   // SBS Block Read Methods
+  uint8_t readBlock(uint8_t command, uint8_t* buffer, uint8_t maxLength);
+  bool runNextScheduledRead(TransactionSchedule& schedule, uint8_t& nextRead, uint8_t& nextBlock, bool& success);
   String readSBSString(uint8_t command);
 };
 
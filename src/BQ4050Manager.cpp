@@ -0,0 +1,156 @@
+#include "BQ4050Manager.h"
+
+BQ4050Manager::BQ4050Manager() : _count(0), _lastSweepSwitches(0), _lastSweepUs(0) {}
+
+int8_t BQ4050Manager::addGauge(BQ4050& gauge, BQ4050Mux* mux, uint8_t channel) {
+  if (_count >= BQ4050_MANAGER_GAUGES || (mux != nullptr && channel >= BQ4050Mux::CHANNELS)) {
+    return -1;
+  }
+  Entry& entry = _entries[_count];
+  entry.gauge = &gauge;
+  entry.mux = mux;
+  entry.channel = (mux != nullptr) ? channel : 0;
+  return (int8_t)_count++;
+}
+
+void BQ4050Manager::clear() {
+  _count = 0;
+}
+
+BQ4050* BQ4050Manager::getGauge(uint8_t index) const {
+  return (index < _count) ? _entries[index].gauge : nullptr;
+}
+
+bool BQ4050Manager::beginAll() {
+  uint8_t order[BQ4050_MANAGER_GAUGES];
+  uint8_t planned = planSweep(order);
+  bool success = true;
+  for (uint8_t i = 0; i < planned; i++) {
+    if (i == 0 || _entries[order[i]].mux != _entries[order[i - 1]].mux) {
+      isolate(_entries[order[i]].mux);
+    }
+    success &= _entries[order[i]].gauge->begin();
+  }
+  return success;
+}
+
+// Every gauge answers at 0x0B, so before talking to one, close the channels of
+// the muxes it does not sit behind. A TCA9548A keeps its channel open after the
+// last transaction; left alone, a second mux or a direct gauge on the same bus
+// would answer together with it. The upstream of a direct gauge is not known,
+// so for those every mux is closed.
+void BQ4050Manager::isolate(BQ4050Mux* keep) {
+  for (uint8_t i = 0; i < _count; i++) {
+    BQ4050Mux* mux = _entries[i].mux;
+    if (mux == nullptr || mux == keep) {
+      continue;
+    }
+    if (keep != nullptr && &mux->getUpstream() != &keep->getUpstream()) {
+      continue;  // Separate bus, no conflict
+    }
+    mux->deselect();  // No bus traffic when already closed
+  }
+}
+
+// Fills order with gauge indices: direct gauges, then per mux (first-added
+// order) the selected channel followed by the others ascending
+uint8_t BQ4050Manager::planSweep(uint8_t* order) const {
+  uint8_t planned = 0;
+  for (uint8_t i = 0; i < _count; i++) {
+    if (_entries[i].mux == nullptr) {
+      order[planned++] = i;
+    }
+  }
+
+  for (uint8_t i = 0; i < _count; i++) {
+    BQ4050Mux* mux = _entries[i].mux;
+    if (mux == nullptr) {
+      continue;
+    }
+    bool seen = false;
+    for (uint8_t j = 0; j < i && !seen; j++) {
+      seen = (_entries[j].mux == mux);
+    }
+    if (seen) {
+      continue;  // Mux already planned
+    }
+
+    // Live selection first (no switch needed), then the other channels ascending
+    uint8_t start = mux->getSelectedChannel();
+    for (uint8_t step = 0; step <= BQ4050Mux::CHANNELS; step++) {
+      uint8_t channel;
+      if (step == 0) {
+        if (start >= BQ4050Mux::CHANNELS) {
+          continue;
+        }
+        channel = start;
+      } else {
+        channel = step - 1;
+        if (channel == start) {
+          continue;
+        }
+      }
+      for (uint8_t k = i; k < _count; k++) {
+        if (_entries[k].mux == mux && _entries[k].channel == channel) {
+          order[planned++] = k;
+        }
+      }
+    }
+  }
+  return planned;
+}
+
+uint32_t BQ4050Manager::totalSwitches() const {
+  uint32_t total = 0;
+  for (uint8_t i = 0; i < _count; i++) {
+    BQ4050Mux* mux = _entries[i].mux;
+    bool seen = false;
+    for (uint8_t j = 0; j < i && !seen; j++) {
+      seen = (_entries[j].mux == mux);
+    }
+    if (mux != nullptr && !seen) {
+      total += mux->getSwitchCount();
+    }
+  }
+  return total;
+}
+
+void BQ4050Manager::forEach(BQ4050SweepCallback callback, void* context) {
+  uint8_t order[BQ4050_MANAGER_GAUGES];
+  uint8_t planned = planSweep(order);
+  uint32_t switches = totalSwitches();
+  uint32_t startUs = micros();
+
+  for (uint8_t i = 0; i < planned; i++) {
+    if (i == 0 || _entries[order[i]].mux != _entries[order[i - 1]].mux) {
+      isolate(_entries[order[i]].mux);
+    }
+    callback(order[i], *_entries[order[i]].gauge, context);
+  }
+
+  _lastSweepUs = micros() - startUs;
+  _lastSweepSwitches = totalSwitches() - switches;
+}
+
+namespace {
+  struct SweepContext {
+    uint32_t fields;
+    BatterySnapshot* results;
+    uint8_t succeeded;
+  };
+
+  void snapshotGauge(uint8_t index, BQ4050& gauge, void* context) {
+    SweepContext* sweep = static_cast<SweepContext*>(context);
+    sweep->results[index] = gauge.readSnapshot(sweep->fields);
+    // The last error only reflects the final read; a gauge succeeds when every field arrived
+    if (sweep->results[index].fields == sweep->fields) {
+      sweep->succeeded++;
+    }
+  }
+}
+
+uint8_t BQ4050Manager::sweep(uint32_t fields, BatterySnapshot* results) {
+  SweepContext context = {fields, results, 0};
+  forEach(snapshotGauge, &context);
+  return context.succeeded;
+}
@@ -0,0 +1,75 @@
+#ifndef BQ4050MANAGER_H
+#define BQ4050MANAGER_H
+
+#include "BQ4050.h"
+
+// Gauges one manager can own. Override with -DBQ4050_MANAGER_GAUGES=N.
+#ifndef BQ4050_MANAGER_GAUGES
+  #ifdef __AVR__
+    #define BQ4050_MANAGER_GAUGES 4
+  #else
+    #define BQ4050_MANAGER_GAUGES 16
+  #endif
+#endif
+
+// Called once per gauge during BQ4050Manager::forEach(), in sweep order
+typedef void (*BQ4050SweepCallback)(uint8_t index, BQ4050& gauge, void* context);
+
+/*
+ * Owns a set of gauges spread over separate buses and mux channels and visits
+ * them in an order that needs the fewest mux switches: gauges without a mux
+ * first, then per mux the currently selected channel, then the remaining
+ * channels in ascending order. Before moving to a direct gauge or another mux,
+ * the muxes it could collide with are deselected. A sweep therefore costs one
+ * control write per occupied channel plus one per mux closed, however many
+ * reads each gauge needs.
+ *
+ *   BQ4050Mux mux(wireTransport);
+ *   BQ4050MuxChannel ch0(mux, 0), ch1(mux, 1);
+ *   BQ4050 packA(ch0), packB(ch1);
+ *
+ *   BQ4050Manager manager;
+ *   manager.addGauge(packA, &mux, 0);
+ *   manager.addGauge(packB, &mux, 1);
+ *   manager.sweep(SNAPSHOT_BASIC, snapshots);
+ */
+class BQ4050Manager {
+public:
+  BQ4050Manager();
+
+  // Returns the gauge index, or -1 when the table is full or the channel is invalid.
+  // Pass the mux/channel the gauge's transport goes through (none for a direct bus).
+  int8_t addGauge(BQ4050& gauge, BQ4050Mux* mux = nullptr, uint8_t channel = 0);
+  void clear();
+  uint8_t getGaugeCount() const { return _count; }
+  BQ4050* getGauge(uint8_t index) const;
+
+  bool beginAll();                                      // true if every gauge started
+
+  // Visit every gauge in minimal-switch order
+  void forEach(BQ4050SweepCallback callback, void* context = nullptr);
+
+  // Coordinated poll: results[i] is filled for gauge index i (array of getGaugeCount()).
+  // Returns the number of gauges whose snapshot captured every requested field.
+  uint8_t sweep(uint32_t fields, BatterySnapshot* results);
+
+  uint32_t getLastSweepSwitches() const { return _lastSweepSwitches; }
+  uint32_t getLastSweepUs() const { return _lastSweepUs; }
+
+private:
+  struct Entry {
+    BQ4050* gauge;
+    BQ4050Mux* mux;
+    uint8_t channel;
+  };
+  Entry _entries[BQ4050_MANAGER_GAUGES];
+  uint8_t _count;
+  uint32_t _lastSweepSwitches;
+  uint32_t _lastSweepUs;
+
+  uint8_t planSweep(uint8_t* order) const;
+  void isolate(BQ4050Mux* keep);
+  uint32_t totalSwitches() const;
+};
+
+#endif
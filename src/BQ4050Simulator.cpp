@@ -0,0 +1,515 @@
+#include "BQ4050Simulator.h"
+
+namespace {
+  // Default SealDevice/unseal key pairs from the TRM
+  const uint16_t UNSEAL_KEY_1 = 0x0414;
+  const uint16_t UNSEAL_KEY_2 = 0x3672;
+  const uint16_t FULL_ACCESS_KEY_1 = 0xFFFF;
+  const uint16_t FULL_ACCESS_KEY_2 = 0xFFFF;
+
+  const char SIM_MANUFACTURER_NAME[] = "Texas Inst.";
+  const char SIM_DEVICE_NAME[] = "bq4050";
+  const char SIM_DEVICE_CHEMISTRY[] = "LION";
+
+  bool isSealedMAC(uint16_t command) {
+    return (command >= 0x0001 && command <= 0x0005) || command == 0x0009 || command == 0x0010 ||
+           (command >= 0x0050 && command <= 0x0058) || (command >= 0x0060 && command <= 0x0062) ||
+           (command >= 0x0070 && command <= 0x0072) || command == 0x007A;
+  }
+
+  void putWord(uint8_t* out, uint16_t value) {
+    out[0] = value & 0xFF;
+    out[1] = (value >> 8) & 0xFF;
+  }
+}
+
+BQ4050Simulator::BQ4050Simulator(uint8_t address)
+  : _address(address), _maxTransferLength(BQ4050_WIRE_BUFFER_SIZE), _busClock(100000),
+    _wireTimeEnabled(true), _maxReliableClock(0), _macLatencyUs(5000) {
+  memset(_dataFlash, 0, sizeof(_dataFlash));
+  resetStatistics();
+  reset();
+}
+
+bool BQ4050Simulator::begin() {
+  return true;
+}
+
+void BQ4050Simulator::setClock(uint32_t frequency) {
+  if (frequency > 0) {
+    _busClock = frequency;
+  }
+}
+
+void BQ4050Simulator::reset() {
+  memset(_sbs, 0, sizeof(_sbs));
+  memset(_status, 0, sizeof(_status));
+
+  _sbs[0x03] = 0x6001;   // BatteryMode
+  _sbs[0x0C] = 1;        // MaxError
+  _sbs[0x0D] = 75;       // RelativeStateOfCharge
+  _sbs[0x0E] = 70;       // AbsoluteStateOfCharge
+  _sbs[0x0F] = 3000;     // RemainingCapacity
+  _sbs[0x10] = 4000;     // FullChargeCapacity
+  _sbs[0x11] = 0xFFFF;   // RunTimeToEmpty
+  _sbs[0x12] = 0xFFFF;   // AverageTimeToEmpty
+  _sbs[0x13] = 0xFFFF;   // AverageTimeToFull
+  _sbs[0x14] = 2000;     // ChargingCurrent
+  _sbs[0x15] = 16800;    // ChargingVoltage
+  _sbs[0x16] = 0x00C0;   // BatteryStatus: INIT, DSG
+  _sbs[0x17] = 12;       // CycleCount
+  _sbs[0x18] = 4400;     // DesignCapacity
+  _sbs[0x19] = 14400;    // DesignVoltage
+  _sbs[0x1A] = 0x0031;   // SpecificationInfo
+  _sbs[0x1C] = 0x0001;   // SerialNumber
+  _sbs[0x4F] = 95;       // StateOfHealth
+
+  for (uint8_t cell = 0; cell < 4; cell++) {
+    _cellVoltage[cell] = 3700;
+  }
+  _current = 0;
+  _temperature = 2982;   // 25 C
+
+  _pendingKey = 0;
+  _macCommand = 0;
+  _macStartUs = micros() - _macLatencyUs;
+  _macResponseLength = 0;
+  _staleResponseLength = 0;
+  _failCount = 0;
+  _corruptPEC = false;
+
+  setSecurityMode(BQ4050_SECURITY_SEALED);
+  refreshDerived();
+}
+
+void BQ4050Simulator::resetStatistics() {
+  _transactions = 0;
+  _bytes = 0;
+  _pecErrors = 0;
+  _macCommands = 0;
+}
+
+void BQ4050Simulator::setSecurityMode(BQ4050_SecurityMode mode) {
+  _securityMode = mode;
+
+  // OperationStatus[SEC1,SEC0]: 11 sealed, 10 unsealed, 01 full access
+  uint32_t sec = (mode == BQ4050_SECURITY_FULL_ACCESS) ? 0x1 :
+                 (mode == BQ4050_SECURITY_UNSEALED) ? 0x2 : 0x3;
+  _status[4] = (_status[4] & ~(uint32_t)0x300) | (sec << 8);
+}
+
+void BQ4050Simulator::setRegister(uint8_t reg, uint16_t value) {
+  if (reg < sizeof(_sbs) / sizeof(_sbs[0])) {
+    _sbs[reg] = value;
+  }
+}
+
+uint16_t BQ4050Simulator::getRegister(uint8_t reg) const {
+  return (reg < sizeof(_sbs) / sizeof(_sbs[0])) ? _sbs[reg] : 0;
+}
+
+void BQ4050Simulator::setCellVoltage(uint8_t cell, uint16_t millivolts) {
+  if (cell >= 1 && cell <= 4) {
+    _cellVoltage[cell - 1] = millivolts;
+    refreshDerived();
+  }
+}
+
+void BQ4050Simulator::setCurrent(int16_t milliamps) {
+  _current = milliamps;
+  refreshDerived();
+}
+
+void BQ4050Simulator::setTemperature(uint16_t deciKelvin) {
+  _temperature = deciKelvin;
+  refreshDerived();
+}
+
+void BQ4050Simulator::setStatus(uint8_t reg, uint32_t value) {
+  if (reg >= BQ4050_CMD_SAFETY_ALERT && reg <= BQ4050_CMD_MANUFACTURING_STATUS) {
+    _status[reg - BQ4050_CMD_SAFETY_ALERT] = value;
+  }
+}
+
+uint32_t BQ4050Simulator::getStatus(uint8_t reg) const {
+  if (reg >= BQ4050_CMD_SAFETY_ALERT && reg <= BQ4050_CMD_MANUFACTURING_STATUS) {
+    return _status[reg - BQ4050_CMD_SAFETY_ALERT];
+  }
+  return 0;
+}
+
+void BQ4050Simulator::refreshDerived() {
+  uint32_t sum = 0;
+  for (uint8_t cell = 0; cell < 4; cell++) {
+    sum += _cellVoltage[cell];
+  }
+  _sbs[BQ4050_CMD_VOLTAGE] = sum;
+  _sbs[BQ4050_CMD_CURRENT] = (uint16_t)_current;
+  _sbs[BQ4050_CMD_AVERAGE_CURRENT] = (uint16_t)_current;
+  _sbs[BQ4050_CMD_TEMPERATURE] = _temperature;
+  _sbs[BQ4050_CMD_CELL_VOLTAGE_1] = _cellVoltage[0];
+  _sbs[BQ4050_CMD_CELL_VOLTAGE_2] = _cellVoltage[1];
+  _sbs[BQ4050_CMD_CELL_VOLTAGE_3] = _cellVoltage[2];
+  _sbs[BQ4050_CMD_CELL_VOLTAGE_4] = _cellVoltage[3];
+}
+
+// Bus model
+bool BQ4050Simulator::beginTransaction(uint8_t address, uint8_t bytes) {
+  _transactions++;
+  _bytes += bytes;
+
+  if (_wireTimeEnabled) {
+    // 9 clocks per byte (8 data + ACK), plus start/stop and address bytes
+    uint32_t bits = (uint32_t)(bytes + 2) * 9 + 2;
+    delayMicroseconds((bits * 1000000UL) / _busClock);
+  }
+
+  if (address != _address) {
+    return false;
+  }
+  if (_failCount > 0) {
+    _failCount--;
+    return false;
+  }
+  return true;
+}
+
+bool BQ4050Simulator::isReadable(uint8_t command) const {
+  if (command > BQ4050_CMD_DA_STATUS_2) {
+    return false;
+  }
+  // Status, AFE, lifetime and DAStatus blocks are unsealed/full access only
+  if (_securityMode == BQ4050_SECURITY_SEALED && command >= 0x4F && command != BQ4050_CMD_MANUFACTURER_INFO) {
+    return false;
+  }
+  return true;
+}
+
+uint8_t BQ4050Simulator::crc8(uint8_t crc, const uint8_t* data, uint8_t length) {
+  for (uint8_t i = 0; i < length; i++) {
+    crc ^= data[i];
+    for (uint8_t bit = 0; bit < 8; bit++) {
+      crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+    }
+  }
+  return crc;
+}
+
+bool BQ4050Simulator::checkWritePEC(const uint8_t* data, uint8_t length, uint8_t payloadLength) {
+  if (length < payloadLength) {
+    return false;
+  }
+  if (length == payloadLength) {
+    return true;  // No PEC sent
+  }
+
+  uint8_t addressByte = _address << 1;
+  uint8_t pec = crc8(crc8(0, &addressByte, 1), data, payloadLength);
+  if (pec != data[payloadLength]) {
+    _pecErrors++;
+    return false;
+  }
+  return true;
+}
+
+uint8_t BQ4050Simulator::write(uint8_t address, const uint8_t* data, uint8_t length) {
+  if (!beginTransaction(address, length)) {
+    return BQ4050_TRANSPORT_ADDRESS_NACK;
+  }
+  if (length < 2) {
+    return BQ4050_TRANSPORT_DATA_NACK;
+  }
+
+  uint8_t command = data[0];
+
+  if (command == 0x00) {
+    // MAC word, optionally followed by a data word; an odd tail byte is PEC
+    uint8_t payloadLength = ((length - 1) & 1) ? length - 1 : length;
+    if (payloadLength < 3 || !checkWritePEC(data, length, payloadLength)) {
+      return BQ4050_TRANSPORT_DATA_NACK;
+    }
+    issueMAC(data[1] | (data[2] << 8));
+    return BQ4050_TRANSPORT_OK;
+  }
+
+  if (command == BQ4050_CMD_MANUFACTURER_BLOCK_ACCESS) {
+    uint8_t payloadLength = 2 + data[1];
+    if (data[1] < 2 || !checkWritePEC(data, length, payloadLength)) {
+      return BQ4050_TRANSPORT_DATA_NACK;
+    }
+    uint16_t target = data[2] | (data[3] << 8);
+    if (target >= DATA_FLASH_START && target < DATA_FLASH_START + DATA_FLASH_SIZE) {
+      if (_securityMode == BQ4050_SECURITY_SEALED) {
+        return BQ4050_TRANSPORT_DATA_NACK;
+      }
+      accessDataFlash(data + 2, data[1]);
+    } else {
+      issueMAC(target);
+    }
+    return BQ4050_TRANSPORT_OK;
+  }
+
+  // Plain SBS word write
+  if (!checkWritePEC(data, length, 3)) {
+    return BQ4050_TRANSPORT_DATA_NACK;
+  }
+  if (command < sizeof(_sbs) / sizeof(_sbs[0])) {
+    _sbs[command] = data[1] | (data[2] << 8);
+  }
+  return BQ4050_TRANSPORT_OK;
+}
+
+uint8_t BQ4050Simulator::writeRead(uint8_t address, const uint8_t* tx, uint8_t txLength,
+                                   uint8_t* rx, uint8_t rxLength, uint8_t& received,
+                                   uint16_t turnaroundUs) {
+  (void)turnaroundUs;
+  received = 0;
+
+  if (!beginTransaction(address, txLength + rxLength)) {
+    return BQ4050_TRANSPORT_ADDRESS_NACK;
+  }
+  if (txLength != 1 || !isReadable(tx[0])) {
+    return BQ4050_TRANSPORT_DATA_NACK;
+  }
+
+  uint8_t command = tx[0];
+  uint8_t body[1 + 34 + 1];
+  uint8_t bodyLength = buildResponse(command, body);
+
+  // ManufacturerAccess() reads are as wide as the caller asks for (word or dword)
+  if (command == 0x00) {
+    bodyLength = (rxLength >= 4) ? 4 : 2;
+  }
+
+  uint8_t header[] = {(uint8_t)(_address << 1), command, (uint8_t)((_address << 1) | 1)};
+  uint8_t pec = crc8(crc8(0, header, sizeof(header)), body, bodyLength);
+  if (_corruptPEC) {
+    pec ^= 0xFF;
+    _corruptPEC = false;
+  }
+  if (_maxReliableClock > 0 && _busClock > _maxReliableClock) {
+    pec ^= 0x01;  // Marginal edges at this clock flip a bit somewhere in the frame
+  }
+  body[bodyLength] = pec;
+
+  // Past the PEC the gauge releases SDA, so the master clocks in 0xFF
+  for (uint8_t i = 0; i < rxLength; i++) {
+    rx[i] = (i <= bodyLength) ? body[i] : 0xFF;
+  }
+  received = rxLength;
+  return BQ4050_TRANSPORT_OK;
+}
+
+// Returns the response bytes (block count included) for a read of command
+uint8_t BQ4050Simulator::buildResponse(uint8_t command, uint8_t* out) {
+  uint8_t macLength = 0;
+  const uint8_t* mac = currentMACResponse(macLength);
+
+  switch (command) {
+    case 0x00:
+      memset(out, 0, 4);
+      if (macLength > 2) {
+        memcpy(out, mac + 2, (macLength - 2 > 4) ? 4 : macLength - 2);
+      }
+      return 4;
+
+    case BQ4050_CMD_MANUFACTURER_NAME:
+    case BQ4050_CMD_DEVICE_NAME:
+    case BQ4050_CMD_DEVICE_CHEMISTRY: {
+      const char* text = (command == BQ4050_CMD_MANUFACTURER_NAME) ? SIM_MANUFACTURER_NAME :
+                         (command == BQ4050_CMD_DEVICE_NAME) ? SIM_DEVICE_NAME : SIM_DEVICE_CHEMISTRY;
+      uint8_t length = strlen(text);
+      out[0] = length;
+      memcpy(out + 1, text, length);
+      return length + 1;
+    }
+
+    case BQ4050_CMD_MANUFACTURER_DATA:
+      // ManufacturerData() carries the MAC payload without the echo
+      out[0] = (macLength > 2) ? macLength - 2 : 0;
+      memcpy(out + 1, mac + 2, out[0]);
+      return out[0] + 1;
+
+    case BQ4050_CMD_MANUFACTURER_BLOCK_ACCESS:
+      out[0] = macLength;
+      memcpy(out + 1, mac, macLength);
+      return macLength + 1;
+
+    default:
+      break;
+  }
+
+  if (command >= BQ4050_CMD_SAFETY_ALERT) {
+    // Block registers mirror the MAC command of the same number
+    uint8_t length = buildMACPayload(command, out + 1);
+    out[0] = length;
+    return length + 1;
+  }
+
+  putWord(out, getRegister(command));
+  return 2;
+}
+
+uint8_t BQ4050Simulator::buildMACPayload(uint16_t command, uint8_t* out) {
+  switch (command) {
+    case BQ4050_MAC_DEVICE_TYPE:
+      putWord(out, 0x4050);
+      return 2;
+
+    case BQ4050_MAC_FIRMWARE_VERSION: {
+      // Device number, version, build number, firmware type, IT version, reserved
+      const uint8_t version[] = {0x50, 0x40, 0x00, 0x01, 0x17, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+      memcpy(out, version, sizeof(version));
+      return sizeof(version);
+    }
+
+    case BQ4050_MAC_HARDWARE_VERSION:
+      putWord(out, 0x0000);
+      return 2;
+
+    case BQ4050_MAC_IF_CHECKSUM:
+    case BQ4050_MAC_STATIC_DF_SIGNATURE:
+    case BQ4050_MAC_ALL_DF_SIGNATURE: {
+      uint16_t sum = 0;
+      for (uint16_t i = 0; i < DATA_FLASH_SIZE; i++) {
+        sum += _dataFlash[i];
+      }
+      putWord(out, sum ^ command);
+      return 2;
+    }
+
+    case BQ4050_MAC_SECURITY_KEYS:
+      putWord(out, UNSEAL_KEY_1);
+      putWord(out + 2, UNSEAL_KEY_2);
+      putWord(out + 4, FULL_ACCESS_KEY_1);
+      putWord(out + 6, FULL_ACCESS_KEY_2);
+      return 8;
+
+    case BQ4050_MAC_DA_STATUS_1: {
+      uint32_t total = 0;
+      int32_t power = 0;
+      for (uint8_t cell = 0; cell < 4; cell++) {
+        total += _cellVoltage[cell];
+        putWord(out + cell * 2, _cellVoltage[cell]);
+        putWord(out + 12 + cell * 2, (uint16_t)_current);
+        // mV * mA = uW; 1 cW = 10000 uW
+        int16_t cellPower = (int16_t)(((int32_t)_cellVoltage[cell] * _current) / 10000);
+        putWord(out + 20 + cell * 2, (uint16_t)cellPower);
+        power += cellPower;
+      }
+      putWord(out + 8, total);        // BAT
+      putWord(out + 10, total);       // PACK
+      putWord(out + 28, (uint16_t)power);
+      putWord(out + 30, (uint16_t)power);
+      return 32;
+    }
+
+    case BQ4050_MAC_DA_STATUS_2:
+      for (uint8_t i = 0; i < 7; i++) {
+        putWord(out + i * 2, _temperature);
+      }
+      return 14;
+
+    case BQ4050_MAC_AFE_REGISTER:
+      memset(out, 0, 20);
+      return 20;
+
+    case BQ4050_MAC_MANUFACTURER_INFO:
+    case BQ4050_MAC_MANUFACTURER_INFO_2:
+    case BQ4050_MAC_LIFETIME_DATA_BLOCK_1:
+    case BQ4050_MAC_LIFETIME_DATA_BLOCK_2:
+    case BQ4050_MAC_LIFETIME_DATA_BLOCK_3:
+    case BQ4050_CMD_LIFETIME_DATA_BLOCK_4:
+    case BQ4050_CMD_LIFETIME_DATA_BLOCK_5:
+      memset(out, 0, 32);
+      return 32;
+
+    default:
+      break;
+  }
+
+  if (command >= BQ4050_MAC_SAFETY_ALERT && command <= BQ4050_MAC_MANUFACTURING_STATUS) {
+    uint32_t value = _status[command - BQ4050_MAC_SAFETY_ALERT];
+    putWord(out, value & 0xFFFF);
+    putWord(out + 2, value >> 16);
+    return 4;
+  }
+
+  // Write-only command: no payload
+  return 0;
+}
+
+// Manufacturer Access processing
+const uint8_t* BQ4050Simulator::currentMACResponse(uint8_t& length) const {
+  if ((uint32_t)(micros() - _macStartUs) >= _macLatencyUs) {
+    length = _macResponseLength;
+    return _macResponse;
+  }
+  length = _staleResponseLength;
+  return _staleResponse;
+}
+
+void BQ4050Simulator::beginMACResponse(uint16_t echo) {
+  _macCommands++;
+
+  // Whatever is visible now stays visible until the new command finishes
+  uint8_t visibleLength = 0;
+  const uint8_t* visible = currentMACResponse(visibleLength);
+  memcpy(_staleResponse, visible, visibleLength);
+  _staleResponseLength = visibleLength;
+
+  _macCommand = echo;
+  _macStartUs = micros();
+  putWord(_macResponse, echo);
+  _macResponseLength = 2;
+}
+
+void BQ4050Simulator::issueMAC(uint16_t command) {
+  // Unseal / full access key pairs are written as two consecutive MAC words
+  uint16_t firstKey = _pendingKey;
+  _pendingKey = command;
+  if (_securityMode == BQ4050_SECURITY_SEALED && firstKey == UNSEAL_KEY_1 && command == UNSEAL_KEY_2) {
+    setSecurityMode(BQ4050_SECURITY_UNSEALED);
+    _pendingKey = 0;
+  } else if (_securityMode == BQ4050_SECURITY_UNSEALED && firstKey == FULL_ACCESS_KEY_1 &&
+             command == FULL_ACCESS_KEY_2) {
+    setSecurityMode(BQ4050_SECURITY_FULL_ACCESS);
+    _pendingKey = 0;
+  }
+
+  beginMACResponse(command);
+
+  if (_securityMode == BQ4050_SECURITY_SEALED && !isSealedMAC(command)) {
+    return;  // Ignored while sealed
+  }
+
+  if (command == BQ4050_MAC_SEAL_DEVICE) {
+    setSecurityMode(BQ4050_SECURITY_SEALED);
+  } else if (command == BQ4050_MAC_RESET_DEVICE) {
+    for (uint8_t i = 0; i < 4; i++) {
+      _status[i] = 0;  // Alerts and status clear on reset
+    }
+  }
+
+  _macResponseLength += buildMACPayload(command, _macResponse + 2);
+}
+
+void BQ4050Simulator::accessDataFlash(const uint8_t* data, uint8_t length) {
+  uint16_t address = data[0] | (data[1] << 8);
+  uint16_t offset = address - DATA_FLASH_START;
+  beginMACResponse(address);
+
+  if (length > 2) {
+    // Write: address followed by the bytes to program
+    for (uint8_t i = 2; i < length && offset + (i - 2) < DATA_FLASH_SIZE; i++) {
+      _dataFlash[offset + (i - 2)] = data[i];
+    }
+    return;
+  }
+
+  // Read: address echo followed by 32 bytes of data flash
+  for (uint8_t i = 0; i < 32; i++) {
+    _macResponse[2 + i] = (offset + i < DATA_FLASH_SIZE) ? _dataFlash[offset + i] : 0;
+  }
+  _macResponseLength = 34;
+}
@@ -0,0 +1,116 @@
+#ifndef BQ4050SIMULATOR_H
+#define BQ4050SIMULATOR_H
+
+#include "BQ4050.h"
+
+/*
+ * Simulated BQ4050 behind the BQ4050Transport interface.
+ *
+ * Plug it in where a Wire/i2c-dev transport would go to exercise or time the
+ * driver without a pack:
+ *
+ *   BQ4050Simulator sim;
+ *   BQ4050 bq4050(sim);
+ *
+ * It answers the SBS commands, MAC subcommands (0x00 / 0x23 / 0x44) with a
+ * configurable processing latency, data flash 0x4000-0x5FFF through
+ * ManufacturerBlockAccess, and appends PEC to every read. Reads issued while
+ * a MAC command is still processing return the previous result, as the gauge
+ * does. Wire time is modelled from the configured bus clock.
+ *
+ * extras/host builds it, with the driver, on a Linux machine for regression checks.
+ */
+class BQ4050Simulator : public BQ4050Transport {
+public:
+  static const uint16_t DATA_FLASH_START = 0x4000;
+  static const uint16_t DATA_FLASH_SIZE = 0x2000;   // 0x4000-0x5FFF
+
+  explicit BQ4050Simulator(uint8_t address = 0x0B);
+
+  // BQ4050Transport
+  bool begin() override;
+  void setClock(uint32_t frequency) override;
+  uint8_t writeRead(uint8_t address, const uint8_t* tx, uint8_t txLength,
+                    uint8_t* rx, uint8_t rxLength, uint8_t& received,
+                    uint16_t turnaroundUs = 0) override;
+  uint8_t write(uint8_t address, const uint8_t* data, uint8_t length) override;
+  uint8_t maxTransferLength() const override { return _maxTransferLength; }
+
+  // Device state
+  void reset();                                         // Power-on defaults
+  void setSecurityMode(BQ4050_SecurityMode mode);
+  BQ4050_SecurityMode getSecurityMode() const { return _securityMode; }
+  void setRegister(uint8_t reg, uint16_t value);        // Raw SBS word (0x01-0x3F)
+  uint16_t getRegister(uint8_t reg) const;
+  void setCellVoltage(uint8_t cell, uint16_t millivolts);  // Also updates Voltage() and DAStatus1
+  void setCurrent(int16_t milliamps);                   // Current(), AverageCurrent() and cell currents
+  void setTemperature(uint16_t deciKelvin);             // Temperature() and every DAStatus2 sensor
+  void setStatus(uint8_t reg, uint32_t value);          // 0x50-0x57 H4 status registers
+  uint32_t getStatus(uint8_t reg) const;
+  uint8_t* getDataFlash() { return _dataFlash; }
+
+  // Timing model
+  void setMACLatency(uint32_t microseconds) { _macLatencyUs = microseconds; }
+  uint32_t getMACLatency() const { return _macLatencyUs; }
+  void setMaxTransferLength(uint8_t length) { _maxTransferLength = length; }
+  void setWireTimeEnabled(bool enable) { _wireTimeEnabled = enable; }
+  void setMaxReliableClock(uint32_t frequency) { _maxReliableClock = frequency; }  // Reads above it fail PEC; 0 = no limit
+
+  // Fault injection
+  void failNextTransactions(uint8_t count) { _failCount = count; }
+  void corruptNextPEC() { _corruptPEC = true; }
+
+  // Statistics
+  uint32_t getTransactionCount() const { return _transactions; }
+  uint32_t getBytesTransferred() const { return _bytes; }
+  uint32_t getPECErrorCount() const { return _pecErrors; }
+  uint32_t getMACCommandCount() const { return _macCommands; }
+  void resetStatistics();
+
+private:
+  uint8_t _address;
+  uint8_t _maxTransferLength;
+  uint32_t _busClock;
+  bool _wireTimeEnabled;
+  uint32_t _maxReliableClock;
+
+  uint16_t _sbs[0x40];
+  uint32_t _status[8];
+  uint16_t _cellVoltage[4];
+  int16_t _current;
+  uint16_t _temperature;
+  BQ4050_SecurityMode _securityMode;
+  uint16_t _pendingKey;                // First half of an unseal/full-access key pair
+  uint8_t _dataFlash[DATA_FLASH_SIZE];
+
+  // MAC processing: the result only becomes visible after _macLatencyUs
+  uint16_t _macCommand;
+  uint32_t _macStartUs;
+  uint32_t _macLatencyUs;
+  uint8_t _macResponse[34];            // 2-byte echo + up to 32 payload bytes
+  uint8_t _macResponseLength;
+  uint8_t _staleResponse[34];
+  uint8_t _staleResponseLength;
+
+  uint8_t _failCount;
+  bool _corruptPEC;
+  uint32_t _transactions;
+  uint32_t _bytes;
+  uint32_t _pecErrors;
+  uint32_t _macCommands;
+
+  bool beginTransaction(uint8_t address, uint8_t bytes);
+  bool isReadable(uint8_t command) const;
+  bool checkWritePEC(const uint8_t* data, uint8_t length, uint8_t payloadLength);
+  uint8_t buildResponse(uint8_t command, uint8_t* out);
+  const uint8_t* currentMACResponse(uint8_t& length) const;
+  void beginMACResponse(uint16_t echo);
+  void issueMAC(uint16_t command);
+  void accessDataFlash(const uint8_t* data, uint8_t length);
+  uint8_t buildMACPayload(uint16_t command, uint8_t* out);
+  void refreshDerived();
+
+  static uint8_t crc8(uint8_t crc, const uint8_t* data, uint8_t length);
+};
+
+#endif
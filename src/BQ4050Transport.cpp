@@ -0,0 +1,425 @@
+#include "BQ4050Transport.h"
+
+#if defined(__linux__)
+  #include <errno.h>
+  #include <fcntl.h>
+  #include <linux/i2c.h>
+  #include <linux/i2c-dev.h>
+  #include <sys/ioctl.h>
+  #include <unistd.h>
+#endif
+
+// Shared-bus lock
+#if defined(ESP32)
+BQ4050BusMutex::BQ4050BusMutex() : _mutex(xSemaphoreCreateRecursiveMutex()) {}
+
+BQ4050BusMutex::~BQ4050BusMutex() {
+  vSemaphoreDelete(_mutex);
+}
+
+bool BQ4050BusMutex::lock(uint32_t timeoutMs) {
+  return xSemaphoreTakeRecursive(_mutex, pdMS_TO_TICKS(timeoutMs)) == pdTRUE;
+}
+
+void BQ4050BusMutex::unlock() {
+  xSemaphoreGiveRecursive(_mutex);
+}
+#else
+namespace {
+  // Masks interrupts around the lock bookkeeping and puts back the caller's
+  // previous state, so a lock taken with interrupts already off leaves them off
+  class InterruptGuard {
+  public:
+#if defined(__AVR__)
+    InterruptGuard() : _sreg(SREG) { cli(); }
+    ~InterruptGuard() { SREG = _sreg; }
+
+  private:
+    uint8_t _sreg;
+#elif defined(__arm__) && !defined(__linux__)
+    InterruptGuard() { __asm__ volatile("mrs %0, primask\n\tcpsid i" : "=r"(_primask) : : "memory"); }
+    ~InterruptGuard() { __asm__ volatile("msr primask, %0" : : "r"(_primask) : "memory"); }
+
+  private:
+    uint32_t _primask;
+#else
+    InterruptGuard() { noInterrupts(); }
+    ~InterruptGuard() { interrupts(); }
+#endif
+  };
+}
+
+__attribute__((weak)) uintptr_t bq4050BusLockContext() {
+  return 0;
+}
+
+BQ4050BusMutex::BQ4050BusMutex() : _owner(0), _depth(0) {}
+
+BQ4050BusMutex::~BQ4050BusMutex() {}
+
+bool BQ4050BusMutex::lock(uint32_t timeoutMs) {
+  uintptr_t context = bq4050BusLockContext();
+  uint32_t start = millis();
+  for (;;) {
+    {
+      InterruptGuard guard;
+      if (_depth == 0 || _owner == context) {
+        _owner = context;
+        _depth++;
+        return true;
+      }
+    }
+    if (millis() - start >= timeoutMs) {
+      return false;
+    }
+    yield();
+  }
+}
+
+void BQ4050BusMutex::unlock() {
+  InterruptGuard guard;
+  if (_depth > 0) {
+    _depth--;
+  }
+}
+#endif
+
+// Arduino Wire backend
+BQ4050WireTransport::BQ4050WireTransport(TwoWire& wire)
+  : _wire(&wire), _sda(-1), _scl(-1), _customPins(false), _frequency(0), _autoRecovery(true) {
+  useDefaultPins();
+}
+
+void BQ4050WireTransport::setWire(TwoWire& wire) {
+  _wire = &wire;
+  _customPins = false;
+  useDefaultPins();
+}
+
+void BQ4050WireTransport::useDefaultPins() {
+  // SDA/SCL belong to Wire; another instance's pins are unknown until given
+  _sda = -1;
+  _scl = -1;
+#if defined(SDA) && defined(SCL)
+  if (_wire == &Wire) {
+    _sda = SDA;
+    _scl = SCL;
+  }
+#endif
+}
+
+bool BQ4050WireTransport::begin() {
+  _customPins = false;
+  _wire->begin();
+  return true;
+}
+
+bool BQ4050WireTransport::begin(int sda, int scl) {
+  _sda = sda;
+  _scl = scl;
+  _customPins = true;
+  _wire->begin(sda, scl);
+  return true;
+}
+
+void BQ4050WireTransport::setClock(uint32_t frequency) {
+  _frequency = frequency;
+  _wire->setClock(frequency);
+}
+
+uint8_t BQ4050WireTransport::writeRead(uint8_t address, const uint8_t* tx, uint8_t txLength,
+                                       uint8_t* rx, uint8_t rxLength, uint8_t& received,
+                                       uint16_t turnaroundUs) {
+  received = 0;
+
+  _wire->beginTransmission(address);
+  _wire->write(tx, txLength);
+  uint8_t status = _wire->endTransmission(false);
+  if (status != BQ4050_TRANSPORT_OK) {
+    return status;
+  }
+
+  if (turnaroundUs > 0) {
+    delayMicroseconds(turnaroundUs);
+  }
+
+  uint8_t bytesReceived = _wire->requestFrom(address, rxLength);
+  while (_wire->available()) {
+    uint8_t value = _wire->read();
+    if (received < rxLength) {
+      rx[received++] = value;
+    }
+  }
+
+  return checkBus((bytesReceived == 0 && rxLength > 0) ? BQ4050_TRANSPORT_TIMEOUT : BQ4050_TRANSPORT_OK);
+}
+
+uint8_t BQ4050WireTransport::write(uint8_t address, const uint8_t* data, uint8_t length) {
+  _wire->beginTransmission(address);
+  _wire->write(data, length);
+  return checkBus(_wire->endTransmission());
+}
+
+// Stuck-bus watchdog: only failures that can leave a slave mid-byte are checked,
+// so healthy traffic never touches the pins
+uint8_t BQ4050WireTransport::checkBus(uint8_t status) {
+  if (!_autoRecovery || _sda < 0 || _scl < 0 ||
+      (status != BQ4050_TRANSPORT_TIMEOUT && status != BQ4050_TRANSPORT_ERROR)) {
+    return status;
+  }
+  if (digitalRead(_sda) == HIGH) {
+    return status;
+  }
+
+  _recoveryStats.stuckDetected++;
+  recoverBus();
+  return status;
+}
+
+bool BQ4050WireTransport::waitForSCL() {
+  // A slave may still stretch the clock; give it up to 1 ms per pulse
+  for (uint16_t i = 0; i < 1000 && digitalRead(_scl) == LOW; i++) {
+    delayMicroseconds(1);
+  }
+  return digitalRead(_scl) == HIGH;
+}
+
+namespace {
+  // Open-drain emulation: a line is either released to its pull-up or driven low,
+  // never driven high. The level is set before the pin becomes an output, since
+  // on AVR an INPUT_PULLUP pin switched to OUTPUT first drives high for a moment
+  // and can hand a clock-stretching slave an extra edge.
+  void driveLineLow(int pin) {
+    digitalWrite(pin, LOW);
+    pinMode(pin, OUTPUT);
+    digitalWrite(pin, LOW);   // Cores whose pinMode() resets the output latch
+  }
+
+  void releaseLine(int pin) {
+    pinMode(pin, INPUT_PULLUP);
+  }
+}
+
+bool BQ4050WireTransport::recoverBus() {
+  if (_sda < 0 || _scl < 0) {
+    return false;
+  }
+
+  // Take the pins back from the peripheral
+  _wire->end();
+  releaseLine(_sda);
+  releaseLine(_scl);
+  delayMicroseconds(5);
+
+  // Clock out whatever byte the slave thinks it is still sending (8 data bits + ACK)
+  for (uint8_t pulse = 0; pulse < 9 && digitalRead(_sda) == LOW; pulse++) {
+    driveLineLow(_scl);
+    delayMicroseconds(5);
+    releaseLine(_scl);
+    if (!waitForSCL()) {
+      break;
+    }
+    delayMicroseconds(5);
+  }
+
+  // STOP: SDA rises while SCL is high
+  driveLineLow(_sda);
+  delayMicroseconds(5);
+  waitForSCL();
+  releaseLine(_sda);
+  delayMicroseconds(5);
+  bool released = digitalRead(_sda) == HIGH && digitalRead(_scl) == HIGH;
+
+  if (_customPins) {
+    _wire->begin(_sda, _scl);
+  } else {
+    _wire->begin();
+  }
+  if (_frequency > 0) {
+    _wire->setClock(_frequency);
+  }
+
+  if (released) {
+    _recoveryStats.recoveries++;
+  } else {
+    _recoveryStats.failedRecoveries++;
+  }
+  return released;
+}
+
+// TCA9548A multiplexer
+BQ4050Mux::BQ4050Mux(BQ4050Transport& upstream, uint8_t address)
+  : _upstream(&upstream), _address(address), _selected(NO_CHANNEL), _known(false), _switches(0) {}
+
+uint8_t BQ4050Mux::writeControl(uint8_t control, uint8_t channel) {
+  uint8_t status = _upstream->write(_address, &control, 1);
+  if (status != BQ4050_TRANSPORT_OK) {
+    invalidate();
+    return status;
+  }
+  _selected = channel;
+  _known = true;
+  _switches++;
+  return BQ4050_TRANSPORT_OK;
+}
+
+uint8_t BQ4050Mux::select(uint8_t channel) {
+  if (channel >= CHANNELS) {
+    return BQ4050_TRANSPORT_ERROR;
+  }
+  if (_known && _selected == channel) {
+    return BQ4050_TRANSPORT_OK;
+  }
+  return writeControl((uint8_t)(1 << channel), channel);
+}
+
+uint8_t BQ4050Mux::deselect() {
+  if (_known && _selected == NO_CHANNEL) {
+    return BQ4050_TRANSPORT_OK;
+  }
+  return writeControl(0x00, NO_CHANNEL);
+}
+
+BQ4050MuxChannel::BQ4050MuxChannel(BQ4050Mux& mux, uint8_t channel) : _mux(&mux), _channel(channel) {}
+
+bool BQ4050MuxChannel::begin() {
+  if (!_mux->getUpstream().begin()) {
+    return false;
+  }
+  // The upstream may have been re-initialised; do not trust the cached selection
+  _mux->invalidate();
+  return _mux->select(_channel) == BQ4050_TRANSPORT_OK;
+}
+
+void BQ4050MuxChannel::setClock(uint32_t frequency) {
+  _mux->getUpstream().setClock(frequency);
+}
+
+uint8_t BQ4050MuxChannel::writeRead(uint8_t address, const uint8_t* tx, uint8_t txLength,
+                                    uint8_t* rx, uint8_t rxLength, uint8_t& received,
+                                    uint16_t turnaroundUs) {
+  received = 0;
+  uint8_t status = _mux->select(_channel);
+  if (status != BQ4050_TRANSPORT_OK) {
+    return status;
+  }
+  return _mux->getUpstream().writeRead(address, tx, txLength, rx, rxLength, received, turnaroundUs);
+}
+
+uint8_t BQ4050MuxChannel::write(uint8_t address, const uint8_t* data, uint8_t length) {
+  uint8_t status = _mux->select(_channel);
+  if (status != BQ4050_TRANSPORT_OK) {
+    return status;
+  }
+  return _mux->getUpstream().write(address, data, length);
+}
+
+bool BQ4050MuxChannel::recoverBus() {
+  // A clock-out on the upstream side also reaches the selected channel; the
+  // mux itself may have been mid-transaction, so its selection is re-sent
+  bool recovered = _mux->getUpstream().recoverBus();
+  _mux->invalidate();
+  return recovered && _mux->select(_channel) == BQ4050_TRANSPORT_OK;
+}
+
+#if defined(__linux__)
+// Linux i2c-dev backend
+BQ4050LinuxTransport::BQ4050LinuxTransport(const char* device) : _device(device), _fd(-1) {}
+
+BQ4050LinuxTransport::~BQ4050LinuxTransport() {
+  end();
+}
+
+bool BQ4050LinuxTransport::begin() {
+  if (_fd >= 0) {
+    return true;
+  }
+
+  _fd = open(_device, O_RDWR);
+  if (_fd < 0) {
+    return false;
+  }
+
+  // Combined write/read transfers need a plain I2C adapter, not an SMBus-only one
+  unsigned long funcs = 0;
+  if (ioctl(_fd, I2C_FUNCS, &funcs) < 0 || !(funcs & I2C_FUNC_I2C)) {
+    end();
+    return false;
+  }
+  return true;
+}
+
+void BQ4050LinuxTransport::end() {
+  if (_fd >= 0) {
+    close(_fd);
+    _fd = -1;
+  }
+}
+
+uint8_t BQ4050LinuxTransport::statusFromErrno(int error) {
+  switch (error) {
+    case ENXIO:
+    case EREMOTEIO:
+      return BQ4050_TRANSPORT_ADDRESS_NACK;
+    case ETIMEDOUT:
+      return BQ4050_TRANSPORT_TIMEOUT;
+    default:
+      return BQ4050_TRANSPORT_ERROR;
+  }
+}
+
+uint8_t BQ4050LinuxTransport::writeRead(uint8_t address, const uint8_t* tx, uint8_t txLength,
+                                        uint8_t* rx, uint8_t rxLength, uint8_t& received,
+                                        uint16_t turnaroundUs) {
+  // The kernel issues both messages back-to-back; the gauge clock-stretches
+  // instead of needing a host-side turnaround delay.
+  (void)turnaroundUs;
+  received = 0;
+
+  if (_fd < 0) {
+    return BQ4050_TRANSPORT_ERROR;
+  }
+
+  struct i2c_msg messages[2];
+  messages[0].addr = address;
+  messages[0].flags = 0;
+  messages[0].len = txLength;
+  messages[0].buf = const_cast<uint8_t*>(tx);
+  messages[1].addr = address;
+  messages[1].flags = I2C_M_RD;
+  messages[1].len = rxLength;
+  messages[1].buf = rx;
+
+  struct i2c_rdwr_ioctl_data transfer;
+  transfer.msgs = messages;
+  transfer.nmsgs = 2;
+
+  if (ioctl(_fd, I2C_RDWR, &transfer) < 0) {
+    return statusFromErrno(errno);
+  }
+
+  received = rxLength;
+  return BQ4050_TRANSPORT_OK;
+}
+
+uint8_t BQ4050LinuxTransport::write(uint8_t address, const uint8_t* data, uint8_t length) {
+  if (_fd < 0) {
+    return BQ4050_TRANSPORT_ERROR;
+  }
+
+  struct i2c_msg message;
+  message.addr = address;
+  message.flags = 0;
+  message.len = length;
+  message.buf = const_cast<uint8_t*>(data);
+
+  struct i2c_rdwr_ioctl_data transfer;
+  transfer.msgs = &message;
+  transfer.nmsgs = 1;
+
+  if (ioctl(_fd, I2C_RDWR, &transfer) < 0) {
+    return statusFromErrno(errno);
+  }
+  return BQ4050_TRANSPORT_OK;
+}
+#endif
@@ -0,0 +1,247 @@
+#ifndef BQ4050TRANSPORT_H
+#define BQ4050TRANSPORT_H
+
+#include <Arduino.h>
+#include <Wire.h>
+
+// Largest single read the platform's Wire implementation can buffer.
+// SMBus block reads are sized to fit this so length, data and PEC arrive in
+// one repeated-start transaction. Override with -DBQ4050_WIRE_BUFFER_SIZE=N.
+#ifndef BQ4050_WIRE_BUFFER_SIZE
+  #if defined(I2C_BUFFER_LENGTH)
+    #define BQ4050_WIRE_BUFFER_SIZE I2C_BUFFER_LENGTH
+  #elif defined(BUFFER_LENGTH)
+    #define BQ4050_WIRE_BUFFER_SIZE BUFFER_LENGTH
+  #else
+    #define BQ4050_WIRE_BUFFER_SIZE 32
+  #endif
+#endif
+
+// Transport status codes (same meaning as Wire's endTransmission() results)
+#define BQ4050_TRANSPORT_OK             0
+#define BQ4050_TRANSPORT_TOO_LONG       1  // Transfer does not fit the backend's buffer
+#define BQ4050_TRANSPORT_ADDRESS_NACK   2
+#define BQ4050_TRANSPORT_DATA_NACK      3
+#define BQ4050_TRANSPORT_ERROR          4
+#define BQ4050_TRANSPORT_TIMEOUT        5
+
+// Cooperative lock for a bus shared between drivers or tasks. Any driver on the
+// same TwoWire can take it around its own transfers; BQ4050 holds it for each
+// transaction and across MAC write -> wait -> read sequences.
+class BQ4050BusLock {
+public:
+  virtual ~BQ4050BusLock() {}
+  virtual bool lock(uint32_t timeoutMs) = 0;
+  virtual void unlock() = 0;
+};
+
+#if !defined(ESP32)
+// Execution context asking for a BQ4050BusMutex. Without FreeRTOS the sketch is
+// one context (the default returns 0); a cooperative scheduler can define this to
+// return the running task so its tasks still exclude each other.
+uintptr_t bq4050BusLockContext();
+#endif
+
+// Default lock: a FreeRTOS recursive mutex on ESP32, otherwise an owner/depth
+// counted flag with the same recursive behaviour, waited on with yield(). Either
+// way a BQ4050BusGuard held around gauge calls does not block the gauge itself.
+class BQ4050BusMutex : public BQ4050BusLock {
+public:
+  BQ4050BusMutex();
+  ~BQ4050BusMutex() override;
+
+  bool lock(uint32_t timeoutMs = 100) override;
+  void unlock() override;
+
+private:
+#if defined(ESP32)
+  SemaphoreHandle_t _mutex;
+#else
+  volatile uintptr_t _owner;
+  volatile uint8_t _depth;
+#endif
+};
+
+// Scope guard for other drivers sharing the lock:
+//   BQ4050BusGuard guard(busLock);
+//   if (guard.locked()) { sensor.read(); }
+class BQ4050BusGuard {
+public:
+  explicit BQ4050BusGuard(BQ4050BusLock& lock, uint32_t timeoutMs = 100)
+    : _lock(&lock), _locked(lock.lock(timeoutMs)) {}
+  ~BQ4050BusGuard() { if (_locked) _lock->unlock(); }
+  bool locked() const { return _locked; }
+
+private:
+  BQ4050BusLock* _lock;
+  bool _locked;
+
+  BQ4050BusGuard(const BQ4050BusGuard&);
+  BQ4050BusGuard& operator=(const BQ4050BusGuard&);
+};
+
+// Stuck-bus watchdog counters
+struct BusRecoveryStats {
+  uint32_t stuckDetected;       // Failed transactions that left SDA held low
+  uint32_t recoveries;          // Clock-outs that released the bus
+  uint32_t failedRecoveries;    // SDA still low after 9 clocks + STOP
+};
+
+/*
+ * SMBus transport underneath the BQ4050 driver.
+ *
+ * The driver frames every SBS/MAC/block command itself (including PEC) and
+ * only needs two raw primitives from a backend: a plain write, and a write
+ * followed by a repeated-start read. Backends that can issue the combined
+ * transfer as one operation (i2c-dev I2C_RDWR) should do so.
+ */
+class BQ4050Transport {
+public:
+  virtual ~BQ4050Transport() {}
+
+  virtual bool begin() = 0;
+  virtual void setClock(uint32_t frequency) { (void)frequency; }
+
+  // Write txLength bytes, repeated start, read up to rxLength bytes.
+  // turnaroundUs is a pause between the phases for backends that can insert one.
+  // Returns a BQ4050_TRANSPORT_* status; received is the number of bytes read.
+  virtual uint8_t writeRead(uint8_t address, const uint8_t* tx, uint8_t txLength,
+                            uint8_t* rx, uint8_t rxLength, uint8_t& received,
+                            uint16_t turnaroundUs = 0) = 0;
+
+  // Single write transaction terminated with STOP
+  virtual uint8_t write(uint8_t address, const uint8_t* data, uint8_t length) = 0;
+
+  // Largest read or write the backend can carry in one transaction
+  virtual uint8_t maxTransferLength() const = 0;
+
+  // Free a bus a slave is holding low. Backends that cannot drive the lines
+  // directly return false.
+  virtual bool recoverBus() { return false; }
+  virtual const BusRecoveryStats& getRecoveryStats() const { return _recoveryStats; }
+  void resetRecoveryStats() { memset(&_recoveryStats, 0, sizeof(_recoveryStats)); }
+
+protected:
+  BusRecoveryStats _recoveryStats = {0, 0, 0};
+};
+
+// Arduino Wire backend (the default). A transaction that fails with a
+// timeout or bus error while SDA is held low triggers the standard recovery:
+// up to 9 SCL pulses, a STOP, then Wire is re-initialised. The pins come from
+// begin(sda, scl) or setRecoveryPins(). The core's SDA/SCL are assumed only for
+// the default Wire instance; on any other bus (Wire1, ...) recovery stays off
+// until its pins are given, so it never bit-bangs another bus's lines.
+class BQ4050WireTransport : public BQ4050Transport {
+public:
+  explicit BQ4050WireTransport(TwoWire& wire = Wire);
+
+  void setWire(TwoWire& wire);
+  TwoWire& getWire() const { return *_wire; }
+  void setRecoveryPins(int sda, int scl) { _sda = sda; _scl = scl; }
+  void setAutoRecovery(bool enable) { _autoRecovery = enable; }
+
+  bool begin() override;
+  bool begin(int sda, int scl);
+  void setClock(uint32_t frequency) override;
+
+  uint8_t writeRead(uint8_t address, const uint8_t* tx, uint8_t txLength,
+                    uint8_t* rx, uint8_t rxLength, uint8_t& received,
+                    uint16_t turnaroundUs = 0) override;
+  uint8_t write(uint8_t address, const uint8_t* data, uint8_t length) override;
+  uint8_t maxTransferLength() const override { return BQ4050_WIRE_BUFFER_SIZE; }
+  bool recoverBus() override;
+
+private:
+  TwoWire* _wire;
+  int _sda;
+  int _scl;
+  bool _customPins;             // Wire was started with explicit pins
+  uint32_t _frequency;          // Last setClock() value, 0 = core default
+  bool _autoRecovery;
+
+  uint8_t checkBus(uint8_t status);
+  void useDefaultPins();
+  bool waitForSCL();
+};
+
+// TCA9548A-style I2C multiplexer sitting on an upstream transport. Tracks the
+// selected channel so consecutive transactions on one channel cost no extra
+// control writes.
+class BQ4050Mux {
+public:
+  static const uint8_t CHANNELS = 8;
+  static const uint8_t NO_CHANNEL = 0xFF;
+
+  explicit BQ4050Mux(BQ4050Transport& upstream, uint8_t address = 0x70);
+
+  BQ4050Transport& getUpstream() const { return *_upstream; }
+  uint8_t getAddress() const { return _address; }
+
+  // Returns a BQ4050_TRANSPORT_* status; no bus traffic if already selected
+  uint8_t select(uint8_t channel);
+  uint8_t deselect();                                   // Disconnect every channel
+  uint8_t getSelectedChannel() const { return _selected; }
+  void invalidate() { _selected = NO_CHANNEL; _known = false; }  // Mux state unknown (reset, bus recovery)
+  uint32_t getSwitchCount() const { return _switches; }
+
+private:
+  BQ4050Transport* _upstream;
+  uint8_t _address;
+  uint8_t _selected;
+  bool _known;
+  uint32_t _switches;
+
+  uint8_t writeControl(uint8_t control, uint8_t channel);
+};
+
+// One downstream channel of a BQ4050Mux, usable wherever a transport is
+// expected: BQ4050 gauge(channel3);
+class BQ4050MuxChannel : public BQ4050Transport {
+public:
+  BQ4050MuxChannel(BQ4050Mux& mux, uint8_t channel);
+
+  BQ4050Mux& getMux() const { return *_mux; }
+  uint8_t getChannel() const { return _channel; }
+
+  bool begin() override;
+  void setClock(uint32_t frequency) override;
+  uint8_t writeRead(uint8_t address, const uint8_t* tx, uint8_t txLength,
+                    uint8_t* rx, uint8_t rxLength, uint8_t& received,
+                    uint16_t turnaroundUs = 0) override;
+  uint8_t write(uint8_t address, const uint8_t* data, uint8_t length) override;
+  uint8_t maxTransferLength() const override { return _mux->getUpstream().maxTransferLength(); }
+  bool recoverBus() override;
+  const BusRecoveryStats& getRecoveryStats() const override { return _mux->getUpstream().getRecoveryStats(); }
+
+private:
+  BQ4050Mux* _mux;
+  uint8_t _channel;
+};
+
+#if defined(__linux__)
+// Linux i2c-dev backend (/dev/i2c-N). Every register read is a single
+// I2C_RDWR ioctl carrying the command write and the repeated-start read.
+class BQ4050LinuxTransport : public BQ4050Transport {
+public:
+  explicit BQ4050LinuxTransport(const char* device);
+  ~BQ4050LinuxTransport() override;
+
+  bool begin() override;
+  void end();
+  int getFileDescriptor() const { return _fd; }
+
+  uint8_t writeRead(uint8_t address, const uint8_t* tx, uint8_t txLength,
+                    uint8_t* rx, uint8_t rxLength, uint8_t& received,
+                    uint16_t turnaroundUs = 0) override;
+  uint8_t write(uint8_t address, const uint8_t* data, uint8_t length) override;
+  uint8_t maxTransferLength() const override { return 255; }
+
+private:
+  const char* _device;
+  int _fd;
+
+  static uint8_t statusFromErrno(int error);
+};
+#endif
+
+#endif